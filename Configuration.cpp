@@ -26,6 +26,22 @@ static constexpr GUID FilePathGUID = { 0x341c4082, 0x255b, 0x4a38, { 0x81, 0x53,
 cfg_string FilePathCfg(FilePathGUID, "");
 #pragma endregion
 
+#pragma region Session
+static constexpr GUID PanelCountGUID = { 0x6f3e2a9c, 0x41d7, 0x4b85, { 0x9c, 0x0e, 0xd2, 0xa7, 0x1f, 0x58, 0xb3, 0xe4 }};
+cfg_int PanelCountCfg(PanelCountGUID, 0); // The largest number of panels that existed at the same time during the last session.
+#pragma endregion
+
+#pragma region Advanced Settings
+static constexpr GUID AdvancedSettingsGUID = { 0x685e168e, 0x6292, 0x4b9d, { 0xa1, 0x66, 0xd8, 0x6d, 0xba, 0x9d, 0xeb, 0x8e }};
+static constexpr GUID TraceEnabledGUID     = { 0x4e2278c1, 0xe6a9, 0x4041, { 0x9a, 0xbb, 0x04, 0x52, 0x26, 0xa8, 0xd4, 0x82 }};
+static constexpr GUID RepairMojibakeGUID   = { 0x0e136930, 0x73d5, 0x4f1c, { 0x8b, 0x8d, 0xb9, 0x0a, 0x53, 0x84, 0xc1, 0x9a }};
+
+static advconfig_branch_factory AdvancedSettingsBranch(STR_COMPONENT_NAME, AdvancedSettingsGUID, advconfig_branch::guid_branch_tools, 0.);
+
+advconfig_checkbox_factory TraceEnabledCfg("Record a trace of the panel lifecycle and events (trace.json, requires restart)", TraceEnabledGUID, AdvancedSettingsGUID, 0., false);
+advconfig_checkbox_factory RepairMojibakeCfg("Repair Shift-JIS and EUC-JP tags that were read as Latin-1", RepairMojibakeGUID, AdvancedSettingsGUID, 1., false);
+#pragma endregion
+
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
@@ -5,6 +5,8 @@
 
 #include "pch.h"
 
+#include <SDK/advconfig_impl.h>
+
 /// <summary>
 /// Represents the configuration of the component.
 /// </summary>
@@ -29,6 +31,11 @@ private:
     const int32_t _CurrentVersion = 1;
 };
 
+extern cfg_int PanelCountCfg;
+
+extern advconfig_checkbox_factory TraceEnabledCfg;
+extern advconfig_checkbox_factory RepairMojibakeCfg;
+
 static const std::wstring OnPlaybackStartingCallback              = L"OnPlaybackStarting";
 static const std::wstring OnPlaybackNewTrackCallback              = L"OnPlaybackNewTrack";
 static const std::wstring OnPlaybackStopCallback                  = L"OnPlaybackStop";
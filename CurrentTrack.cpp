@@ -0,0 +1,109 @@
+
+/** $VER: CurrentTrack.cpp (2026.10.17) P. Stuer - Caches the location of the track shown by the panels. **/
+
+#include "pch.h"
+
+#include "CurrentTrack.h"
+
+#include <SDK/ui.h>
+#include <SDK/contextmenu.h>
+#include <SDK/initquit.h>
+
+#pragma hdrstop
+
+current_track_t _CurrentTrack;
+
+/// <summary>
+/// Gets the location and the handle of the current track. Returns false if there is no current track.
+/// </summary>
+bool current_track_t::Get(t_size & playlistIndex, t_size & itemIndex, metadb_handle_ptr & track) noexcept
+{
+    // The playing item can be moved in a playlist that isn't the active one. The callbacks of the panels only cover the active playlist so make sure it's still there.
+    if (_IsValid && _IsPlayingItem)
+    {
+        metadb_handle_ptr Track;
+
+        if (!_PlaylistManager->playlist_get_item_handle(Track, _PlaylistIndex, _ItemIndex) || (Track != _Track))
+            Invalidate();
+    }
+
+    if (!_IsValid)
+        _IsValid = Resolve();
+
+    playlistIndex = _PlaylistIndex;
+    itemIndex     = _ItemIndex;
+    track         = _Track;
+
+    return _Track.is_valid();
+}
+
+/// <summary>
+/// Releases the services and the track. Called when foobar2000 shuts down.
+/// </summary>
+void current_track_t::Reset() noexcept
+{
+    Invalidate();
+
+    _PlaylistManager.release();
+    _Track.release();
+}
+
+/// <summary>
+/// Resolves the index of the playlist and the item of the current track, taking into account the user preferences.
+/// </summary>
+bool current_track_t::Resolve() noexcept
+{
+    if (_PlaylistManager.is_empty())
+        _PlaylistManager = playlist_manager::get();
+
+    _PlaylistIndex = ~0u;
+    _ItemIndex     = ~0u;
+    _Track.release();
+
+    _IsPlayingItem = false;
+
+    auto SelectionType = ui_selection_manager::get()->get_selection_type();
+
+    // Description as used in the Preferences dialog (Display / Selection Viewers).
+    const bool PreferCurrentlyPlayingTrack = (SelectionType == contextmenu_item::caller_now_playing);
+    const bool PreferCurrentSelection      = (SelectionType == contextmenu_item::caller_active_playlist_selection);
+
+    if (PreferCurrentlyPlayingTrack)
+        _IsPlayingItem = _PlaylistManager->get_playing_item_location(&_PlaylistIndex, &_ItemIndex);
+
+    if (PreferCurrentSelection || !_IsPlayingItem)
+    {
+        _IsPlayingItem = false;
+
+        _PlaylistIndex = _PlaylistManager->get_active_playlist();
+
+        if (_PlaylistIndex == ~0u)
+            return true;
+
+        _ItemIndex = _PlaylistManager->playlist_get_focus_item(_PlaylistIndex);
+
+        if (_ItemIndex == ~0u)
+            return true;
+    }
+
+    _PlaylistManager->playlist_get_item_handle(_Track, _PlaylistIndex, _ItemIndex);
+
+    return true;
+}
+
+namespace
+{
+    /// <summary>
+    /// Releases the cached track when foobar2000 shuts down.
+    /// </summary>
+    class current_track_initquit_t : public initquit
+    {
+    public:
+        void on_quit() noexcept override
+        {
+            _CurrentTrack.Reset();
+        }
+    };
+
+    static initquit_factory_t<current_track_initquit_t> _InitQuitFactory;
+}
@@ -0,0 +1,59 @@
+
+/** $VER: CurrentTrack.h (2026.10.17) P. Stuer - Caches the location of the track shown by the panels. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <SDK/playlist.h>
+
+/// <summary>
+/// Caches the track the panels show: the playing track or the focused item of the active playlist, depending on the user preferences.
+/// The track is resolved on first use and kept until a play, playlist or selection callback invalidates it. Each invalidation starts a new generation. Must be used from the main thread.
+/// </summary>
+class current_track_t
+{
+public:
+    current_track_t() noexcept : _PlaylistIndex(~0u), _ItemIndex(~0u), _IsPlayingItem(), _IsValid(), _Generation() { }
+
+    current_track_t(const current_track_t &) = delete;
+    current_track_t & operator=(const current_track_t &) = delete;
+    current_track_t(current_track_t &&) = delete;
+    current_track_t & operator=(current_track_t &&) = delete;
+
+    bool Get(t_size & playlistIndex, t_size & itemIndex, metadb_handle_ptr & track) noexcept;
+
+    /// <summary>
+    /// Marks the cached track as out-of-date. It will be resolved again on next use.
+    /// </summary>
+    void Invalidate() noexcept
+    {
+        _IsValid = false;
+
+        ++_Generation;
+    }
+
+    /// <summary>
+    /// Gets the generation of the cached track. Results computed for the same generation refer to the same track.
+    /// </summary>
+    uint64_t GetGeneration() const noexcept { return _Generation; }
+
+    void Reset() noexcept;
+
+private:
+    bool Resolve() noexcept;
+
+private:
+    playlist_manager::ptr _PlaylistManager;
+
+    t_size _PlaylistIndex;
+    t_size _ItemIndex;
+    metadb_handle_ptr _Track;
+
+    bool _IsPlayingItem;    // True if the track was resolved from the playing item instead of the active playlist.
+    bool _IsValid;
+
+    uint64_t _Generation;
+};
+
+extern current_track_t _CurrentTrack;
@@ -107,6 +107,11 @@ void DUIElement::notify(const GUID & what, t_size param1, const void * param2, t
     {
         SetWebViewVisibility(IsWebViewVisible());
     }
+    else
+    if (what == ui_element_notify_visibility_changed)
+    {
+        SetWindowVisibility(param1 != 0);
+    }
 /*
     if (what == ui_element_notify_colors_changed)
     {
@@ -115,10 +120,6 @@ void DUIElement::notify(const GUID & what, t_size param1, const void * param2, t
     if (what == ui_element_notify_font_changed)
     {
     }
-    else
-    if (what == ui_element_notify_visibility_changed)
-    {
-    }
 */
 }
 
@@ -1,22 +1,106 @@
 ﻿
-/** $VER: Encoding.cpp (2024.05.27) P. Stuer **/
+/** $VER: Encoding.cpp (2026.10.17) P. Stuer **/
 
 #include "pch.h"
 
 #include "Encoding.h"
+#include "EncodingDetector.h"
+#include "JapaneseDecoder.h"
+#include "Transcoder.h"
+
+#include <memory>
 
 /// <summary>
-/// Converts an UTF-16 string of UTF-8.
+/// Lets the converter write up to the specified number of characters into the string and shrinks the string to the number it wrote.
+/// The worst-case capacity is not zero-filled first: resize_and_overwrite() is used where the library has it, otherwise a scratch buffer per thread of which only the result is copied.
+/// </summary>
+template<typename S, typename F>
+static transcode_result_t ConvertInto(S & s, size_t capacity, F convert) noexcept
+{
+    typedef typename S::value_type char_t;
+
+    transcode_result_t Result = { };
+
+#ifdef __cpp_lib_string_resize_and_overwrite
+    s.resize_and_overwrite(capacity, [&](char_t * data, size_t) noexcept
+    {
+        Result = convert(data);
+
+        return Result.Written;
+    });
+#else
+    thread_local std::unique_ptr<char_t[]> Buffer;
+    thread_local size_t BufferSize = 0;
+
+    if (BufferSize < capacity)
+    {
+        Buffer.reset(new (std::nothrow) char_t[capacity]); // Not value-initialized.
+
+        BufferSize = (Buffer != nullptr) ? capacity : 0;
+    }
+
+    if (Buffer != nullptr)
+    {
+        Result = convert(Buffer.get());
+
+        s.assign(Buffer.get(), Result.Written);
+    }
+    else
+    {
+        s.resize(capacity);
+
+        Result = convert(s.data());
+
+        s.resize(Result.Written);
+    }
+#endif
+
+    return Result;
+}
+
+/// <summary>
+/// Converts an UTF-16 string to UTF-8. Returns false, and the text converted up to the error, if the string contains an unpaired surrogate.
+/// </summary>
+bool TryWideToUTF8(const wchar_t * wide, size_t size, std::string & text, transcode_result_t * result) noexcept
+{
+    static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be an UTF-16 code unit.");
+
+    const transcode_result_t Result = ConvertInto(text, GetUTF8Capacity(size), [wide, size](char * data) noexcept { return ::UTF16ToUTF8((const char16_t *) wide, size, data); });
+
+    if (result != nullptr)
+        *result = Result;
+
+    return Result.IsValid();
+}
+
+/// <summary>
+/// Converts an UTF-8 string to UTF-16. Returns false, and the text converted up to the error, if the string is not valid UTF-8.
+/// </summary>
+bool TryUTF8ToWide(const char * text, size_t size, std::wstring & wide, transcode_result_t * result) noexcept
+{
+    const transcode_result_t Result = ConvertInto(wide, GetUTF16Capacity(size), [text, size](wchar_t * data) noexcept { return ::UTF8ToUTF16(text, size, (char16_t *) data); });
+
+    if (result != nullptr)
+        *result = Result;
+
+    return Result.IsValid();
+}
+
+/// <summary>
+/// Converts an UTF-16 string to UTF-8. Unpaired surrogates are replaced by U+FFFD; use TryWideToUTF8() to detect them.
 /// </summary>
 std::string WideToUTF8(const wchar_t * wide, size_t size = 0) noexcept
 {
     if (size == 0)
         size = ::wcslen(wide);
 
-    int Size = ::WideCharToMultiByte(CP_UTF8, 0, wide, (int) size, nullptr, 0, nullptr, nullptr);
-
     std::string UTF8;
 
+    if (TryWideToUTF8(wide, size, UTF8))
+        return UTF8;
+
+    int Size = ::WideCharToMultiByte(CP_UTF8, 0, wide, (int) size, nullptr, 0, nullptr, nullptr);
+
     UTF8.resize((size_t) Size);
 
     ::WideCharToMultiByte(CP_UTF8, 0, wide,  (int) size, UTF8.data(), (int) UTF8.size(), nullptr, nullptr);
@@ -25,14 +109,34 @@ std::string WideToUTF8(const wchar_t * wide, size_t size = 0) noexcept
 }
 
 /// <summary>
-/// Converts a string encoded with the specified code page to an UTF-16 string.
+/// Converts a Shift-JIS or EUC-JP string to UTF-16 with the built-in tables. Returns false if the string contains a character the tables don't cover.
 /// </summary>
-std::wstring CodePageToWide(uint32_t codePage, const char * text, size_t size) noexcept
+static bool TryJapaneseToWide(uint32_t codePage, const char * text, size_t size, std::wstring & wide) noexcept
 {
-    int Size = ::MultiByteToWideChar(codePage, 0, text, (int) size, nullptr, 0);
+    const transcode_result_t Result = ConvertInto(wide, GetJapaneseUTF16Capacity(size), [codePage, text, size](wchar_t * data) noexcept
+    {
+        return (codePage == 932) ? ::ShiftJISToUTF16(text, size, (char16_t *) data) : ::EUCJPToUTF16(text, size, (char16_t *) data);
+    });
+
+    return Result.IsValid();
+}
 
+/// <summary>
+/// Converts a string encoded with the specified code page to an UTF-16 string. Invalid UTF-8 is replaced by U+FFFD; use TryUTF8ToWide() to detect it.
+/// Code pages 932, 20932 and 51932 are decoded with built-in tables; the code page tables of the operating system are only used for the characters they don't cover.
+/// </summary>
+std::wstring CodePageToWide(uint32_t codePage, const char * text, size_t size) noexcept
+{
     std::wstring Wide;
 
+    if ((codePage == CP_UTF8) && TryUTF8ToWide(text, size, Wide))
+        return Wide;
+
+    if (((codePage == 932) || (codePage == 20932) || (codePage == 51932)) && TryJapaneseToWide(codePage, text, size, Wide))
+        return Wide;
+
+    int Size = ::MultiByteToWideChar(codePage, 0, text, (int) size, nullptr, 0);
+
     Wide.resize((size_t) Size);
 
     ::MultiByteToWideChar(codePage, 0, text,  (int) size, Wide.data(), (int) Wide.size());
@@ -61,10 +165,12 @@ std::string FormatText(const char * format, ...) noexcept
 
     Text.resize(256);
 
-    ::vsprintf_s(Text.data(), Text.size(), format, vl);
+    int Length = ::vsprintf_s(Text.data(), Text.size(), format, vl);
 
     va_end(vl);
 
+    Text.resize((Length > 0) ? (size_t) Length : 0);
+
     return Text;
 }
 
@@ -81,141 +187,101 @@ std::wstring FormatText(const wchar_t * format, ...) noexcept
 
     Text.resize(256);
 
-    ::vswprintf_s(Text.data(), Text.size(), format, vl);
+    int Length = ::vswprintf_s(Text.data(), Text.size(), format, vl);
 
     va_end(vl);
 
+    Text.resize((Length > 0) ? (size_t) Length : 0);
+
     return Text;
 }
 
 /// <summary>
-/// Returns true if the specified text is EUC-JP encoded. (http://www.rikai.com/library/kanjitables/kanji_codes.euc.shtml)
+/// Converts a string to a quoted JSON string literal.
 /// </summary>
-bool IsEUCJP(const char * text, size_t size) noexcept
+std::wstring ToJSONString(const std::wstring & text) noexcept
 {
-    while (size != 0)
-    {
-        uint8_t d1 = (uint8_t) *text++;
-        size--;
-
-        if (!((d1 >= 0xA1 && d1 <= 0xAD) || (d1 >= 0xB0 && d1 <= 0xFE)))
-            continue;
+    std::wstring JSON;
 
-        if (size == 0)
-            return false;
+    JSON.reserve(text.length() + 2);
 
-        uint8_t d2 = (uint8_t) *text++;
-        size--;
+    JSON.push_back(L'"');
 
-        if (!(d2 >= 0xA0 && d1 <= 0xFF))
-            return false;
-    }
-
-    return true;
-}
-
-/// <summary>
-/// Returns true if the specified text is Shift-JIS encoded. (http://www.rikai.com/library/kanjitables/kanji_codes.sjis.shtml)
-/// </summary>
-bool IsShiftJIS(const char * text, size_t size) noexcept
-{
-    while (size != 0)
+    for (wchar_t c : text)
     {
-        uint8_t d1 = (uint8_t) *text++;
-        size--;
-
-        if (!((d1 >= 0x81 && d1 <= 0x84) || (d1 >= 0x87 && d1 <= 0x9F) || (d1 >= 0xE0 && d1 <= 0xEF)))
-            continue;
-
-        if (size == 0)
-            return false;
-
-        uint8_t d2 = (uint8_t) *text++;
-        size--;
-
-        if (!((d2 >= 0x40 && d2 <= 0x9E) || (d2 >= 0x9F && d2 <= 0xFC)))
-            return false;
-    }
-
-    return true;
-}
-
-/// <summary>
-/// Returns true if the specified text is UTF-8 encoded.
-/// </summary>
-bool IsUTF8(const char * text, size_t size) noexcept
-{
-    size_t n = 0;
-
-    for (size_t i = 0; i < size; ++i)
-    {
-        uint8_t c = (uint8_t ) text[i];
-
-        //if (c==0x09 || c==0x0a || c==0x0d || (0x20 <= c && c <= 0x7e) ) n = 0; // is_printable_ascii
-        if ((0x00 <= c) && (c <= 0x7F))
-            n = 0; // 0bbbbbbb
-        else
-        if ((c & 0xE0) == 0xC0)
-            n = 1; // 110bbbbb
-        else
-        if ((c == 0xED) && (i < (size - 1)) && (((uint8_t) text[i + 1] & 0xA0) == 0xA0))
-            return false; // U+d800 to U+dfff
-
-        if ((c & 0xF0) == 0xE0)
-            n = 2; // 1110bbbb
-        else
-        if ((c & 0xF8) == 0xF0)
-            n = 3; // 11110bbb
-//      else
-//      if ((c & 0xFC) == 0xF8)
-//          n = 4; // 111110bb // byte 5, unnecessary in 4 byte UTF-8
-//      if ((c & 0xFE) == 0xFC)
-//          n = 5; // 1111110b // byte 6, unnecessary in 4 byte UTF-8
-        else
-            return false;
-
-        // Are there n bytes matching 10bbbbbb following?
-        for (size_t j = 0; (j < n) && (i < size); ++j)
-        { 
-            if ((++i == size) || (((uint8_t) text[i] & 0xC0) != 0x80))
-                return false;
+        switch (c)
+        {
+            case L'"':  JSON.append(L"\\\""); break;
+            case L'\\': JSON.append(L"\\\\"); break;
+            case L'\b': JSON.append(L"\\b"); break;
+            case L'\f': JSON.append(L"\\f"); break;
+            case L'\n': JSON.append(L"\\n"); break;
+            case L'\r': JSON.append(L"\\r"); break;
+            case L'\t': JSON.append(L"\\t"); break;
+
+            default:
+            {
+                if (c < 0x20)
+                {
+                    wchar_t Escape[8];
+
+                    ::swprintf_s(Escape, _countof(Escape), L"\\u%04X", (unsigned int) c);
+
+                    JSON.append(Escape);
+                }
+                else
+                    JSON.push_back(c);
+            }
         }
     }
 
-    return true;
+    JSON.push_back(L'"');
+
+    return JSON;
 }
 
 /// <summary>
-/// Returns true if the specified text is ASCII encoded.
+/// Converts an UTF-8 string to a quoted JSON string literal.
 /// </summary>
-bool IsASCII(const char * text) noexcept
+std::string ToJSONString(const char * text) noexcept
 {
-    while (*text)
-    {
-        if (*text < 0)
-            return false;
+    std::string JSON;
 
-        ++text;
-    }
-
-    return true;
-}
+    JSON.push_back('"');
 
-/// <summary>
-/// Returns true if the specified text is ASCII encoded.
-/// </summary>
-bool IsASCII(const char * text, size_t size) noexcept
-{
-    while (size != 0)
+    for (; *text != '\0'; ++text)
     {
-        if (*text < 0)
-            return false;
-
-        ++text;
-        --size;
+        const char c = *text;
+
+        switch (c)
+        {
+            case '"':  JSON.append("\\\""); break;
+            case '\\': JSON.append("\\\\"); break;
+            case '\b': JSON.append("\\b"); break;
+            case '\f': JSON.append("\\f"); break;
+            case '\n': JSON.append("\\n"); break;
+            case '\r': JSON.append("\\r"); break;
+            case '\t': JSON.append("\\t"); break;
+
+            default:
+            {
+                if ((unsigned char) c < 0x20)
+                {
+                    char Escape[8];
+
+                    ::sprintf_s(Escape, _countof(Escape), "\\u%04X", (unsigned int) c);
+
+                    JSON.append(Escape);
+                }
+                else
+                    JSON.push_back(c);
+            }
+        }
     }
 
-    return true;
+    JSON.push_back('"');
+
+    return JSON;
 }
 
 /// <summary>
@@ -226,19 +292,21 @@ std::wstring TextToWide(const char * text, size_t size) noexcept
     if (size == 0)
         size = ::strlen(text);
 
-    if (IsASCII(text))
-        return UTF8ToWide(text);
-
-    if (IsUTF8(text, size))
-        return UTF8ToWide(text);
+    switch (DetectEncoding(text, size))
+    {
+        case encoding_t::ASCII:
+        case encoding_t::UTF8:
+            return UTF8ToWide(text, size);
 
-    if (IsShiftJIS(text, size))
-        return CodePageToWide(932, text);
+        case encoding_t::ShiftJIS:
+            return CodePageToWide(932, text, size);
 
-    if (IsEUCJP(text, size))
-        return CodePageToWide(20932, text);
+        case encoding_t::EUCJP:
+            return CodePageToWide(20932, text, size);
 
-    return CodePageToWide(51932, text);
+        default:
+            return CodePageToWide(51932, text, size);
+    }
 }
 
 /// <summary>
@@ -249,25 +317,21 @@ std::string TextToUTF8(const char * text, size_t size) noexcept
     if (size == 0)
         size = ::strlen(text);
 
-    if (IsASCII(text, size) || IsUTF8(text, size))
+    switch (DetectEncoding(text, size))
     {
-        std::string Text;
+        case encoding_t::ASCII:
+        case encoding_t::UTF8:
+            return std::string(text, size);
 
-        Text.resize(size + 1);
+        case encoding_t::ShiftJIS:
+            return CodePageToUTF8(932, text, size);
 
-        ::memcpy(Text.data(), text, size);
-        Text[size] = '\0';
+        case encoding_t::EUCJP:
+            return CodePageToUTF8(20932, text, size);
 
-        return Text;
+        default:
+            return CodePageToUTF8(51932, text, size);
     }
-
-    if (IsShiftJIS(text, size))
-        return CodePageToUTF8(932, text, size);
-
-    if (IsEUCJP(text, size))
-        return CodePageToUTF8(20932, text, size);
-
-    return CodePageToUTF8(51932, text, size);
 }
 
 #ifdef _DEBUG
@@ -1,10 +1,16 @@
 
-/** $VER: Encoding.h (2024.05.18) P. Stuer **/
+/** $VER: Encoding.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
 #include "framework.h"
 
+#include "Validators.h"
+#include "Transcoder.h"
+
+bool TryWideToUTF8(const wchar_t * wide, size_t size, std::string & text, transcode_result_t * result = nullptr) noexcept;
+bool TryUTF8ToWide(const char * text, size_t size, std::wstring & wide, transcode_result_t * result = nullptr) noexcept;
+
 std::string WideToUTF8(const wchar_t * wide, size_t size) noexcept;
 std::wstring TextToWide(const char * text, size_t size = 0) noexcept;
 
@@ -36,7 +42,5 @@ inline std::wstring UTF8ToWide(const std::string & text) noexcept
 std::string FormatText(const char * format, ...) noexcept;
 std::wstring FormatText(const wchar_t * format, ...) noexcept;
 
-bool IsEUCJP(const char * text, size_t size) noexcept;
-bool IsShiftJIS(const char * text, size_t size) noexcept;
-bool IsUTF8(const char * text, size_t size) noexcept;
-bool IsASCII(const char * text, size_t size) noexcept;
+std::wstring ToJSONString(const std::wstring & text) noexcept;
+std::string ToJSONString(const char * text) noexcept;
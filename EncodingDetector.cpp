@@ -0,0 +1,230 @@
+
+/** $VER: EncodingDetector.cpp (2026.10.17) P. Stuer - Detects the encoding of a text in a single pass. **/
+
+#include "EncodingDetector.h"
+#include "Validators.h"
+
+/// <summary>
+/// Feeds the next chunk of the text to the detector.
+/// </summary>
+void encoding_detector_t::Feed(const char * data, size_t size) noexcept
+{
+    const uint8_t * Data = (const uint8_t *) data;
+
+    size_t i = 0;
+
+    while ((i < size) && !IsDone())
+    {
+        // ASCII is valid in all encodings as long as no multi-byte character is pending.
+        if ((Data[i] < 0x80) && !IsPending())
+        {
+            i += SkipASCII(data + i, size - i);
+            continue;
+        }
+
+        const uint8_t c = Data[i++];
+
+        if (c >= 0x80)
+            _Candidates &= ~ASCIIBit;
+
+        if (_Candidates & UTF8Bit)
+            FeedUTF8(c);
+
+        if (_Candidates & ShiftJISBit)
+            FeedShiftJIS(c);
+
+        if (_Candidates & EUCJPBit)
+            FeedEUCJP(c);
+    }
+}
+
+/// <summary>
+/// Signals the end of the text. Candidates that are in the middle of a character are eliminated.
+/// </summary>
+void encoding_detector_t::Finish() noexcept
+{
+    if (_UTF8.Remaining != 0)
+        _Candidates &= ~UTF8Bit;
+
+    if (_ShiftJIS.Lead != 0)
+        _Candidates &= ~ShiftJISBit;
+
+    if (_EUCJP.Remaining != 0)
+        _Candidates &= ~EUCJPBit;
+
+    _IsFinished = true;
+}
+
+/// <summary>
+/// Gets the most likely encoding of the text: the remaining candidate with the highest score. Ties are resolved in the order UTF-8, Shift-JIS, EUC-JP.
+/// </summary>
+encoding_t encoding_detector_t::GetEncoding() const noexcept
+{
+    if (_Candidates & ASCIIBit)
+        return encoding_t::ASCII;
+
+    encoding_t Encoding = encoding_t::Unknown;
+    uint32_t Score = 0;
+
+    const struct { encoding_t Encoding; uint32_t Score; } Candidates[] =
+    {
+        { encoding_t::UTF8,     _UTF8.Score },
+        { encoding_t::ShiftJIS, _ShiftJIS.Score },
+        { encoding_t::EUCJP,    _EUCJP.Score },
+    };
+
+    for (const auto & Candidate : Candidates)
+    {
+        if (IsCandidate(Candidate.Encoding) && ((Encoding == encoding_t::Unknown) || (Candidate.Score > Score)))
+        {
+            Encoding = Candidate.Encoding;
+            Score = Candidate.Score;
+        }
+    }
+
+    return Encoding;
+}
+
+/// <summary>
+/// Advances the UTF-8 state machine. Accepts only the well-formed sequences of the Unicode Standard (Table 3-7).
+/// </summary>
+void encoding_detector_t::FeedUTF8(uint8_t c) noexcept
+{
+    if (_UTF8.Remaining != 0)
+    {
+        if ((c < _UTF8.Lo) || (c > _UTF8.Hi))
+        {
+            _Candidates &= ~UTF8Bit;
+            return;
+        }
+
+        _UTF8.Lo = 0x80;
+        _UTF8.Hi = 0xBF;
+
+        if (--_UTF8.Remaining == 0)
+            _UTF8.Score += 2; // A multi-byte sequence is unlikely to be valid by accident.
+
+        return;
+    }
+
+    if (c < 0x80)
+        return;
+
+    _UTF8.Lo = 0x80;
+    _UTF8.Hi = 0xBF;
+
+    if ((c >= 0xC2) && (c <= 0xDF))
+        _UTF8.Remaining = 1;
+    else
+    if ((c >= 0xE0) && (c <= 0xEF))
+    {
+        _UTF8.Remaining = 2;
+
+        if (c == 0xE0) _UTF8.Lo = 0xA0; else
+        if (c == 0xED) _UTF8.Hi = 0x9F;
+    }
+    else
+    if ((c >= 0xF0) && (c <= 0xF4))
+    {
+        _UTF8.Remaining = 3;
+
+        if (c == 0xF0) _UTF8.Lo = 0x90; else
+        if (c == 0xF4) _UTF8.Hi = 0x8F;
+    }
+    else
+        _Candidates &= ~UTF8Bit;
+}
+
+/// <summary>
+/// Advances the Shift-JIS (code page 932) state machine. Characters of JIS X 0208 score a point; half-width katakana and the vendor extensions don't.
+/// </summary>
+void encoding_detector_t::FeedShiftJIS(uint8_t c) noexcept
+{
+    if (_ShiftJIS.Lead != 0)
+    {
+        if (!((c >= 0x40 && c <= 0x7E) || (c >= 0x80 && c <= 0xFC)))
+        {
+            _Candidates &= ~ShiftJISBit;
+            return;
+        }
+
+        const uint8_t Lead = _ShiftJIS.Lead;
+
+        if ((Lead >= 0x81 && Lead <= 0x84) || (Lead >= 0x88 && Lead <= 0x9F) || (Lead >= 0xE0 && Lead <= 0xEA))
+            _ShiftJIS.Score += 1;
+
+        _ShiftJIS.Lead = 0;
+
+        return;
+    }
+
+    if ((c < 0x80) || ((c >= 0xA1) && (c <= 0xDF)))
+        return;
+
+    if ((c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC))
+        _ShiftJIS.Lead = c;
+    else
+        _Candidates &= ~ShiftJISBit;
+}
+
+/// <summary>
+/// Advances the EUC-JP state machine. Characters of JIS X 0208 score a point; half-width katakana (SS2) and JIS X 0212 (SS3) don't.
+/// </summary>
+void encoding_detector_t::FeedEUCJP(uint8_t c) noexcept
+{
+    if (_EUCJP.Remaining != 0)
+    {
+        if ((c < _EUCJP.Lo) || (c > _EUCJP.Hi))
+        {
+            _Candidates &= ~EUCJPBit;
+            return;
+        }
+
+        _EUCJP.Lo = 0xA1;
+        _EUCJP.Hi = 0xFE;
+
+        if (--_EUCJP.Remaining == 0)
+        {
+            const uint8_t Lead = _EUCJP.Lead;
+
+            if ((Lead >= 0xA1 && Lead <= 0xA8) || (Lead >= 0xB0 && Lead <= 0xF4))
+                _EUCJP.Score += 1;
+        }
+
+        return;
+    }
+
+    if (c < 0x80)
+        return;
+
+    _EUCJP.Lead = c;
+    _EUCJP.Lo = 0xA1;
+    _EUCJP.Hi = 0xFE;
+
+    if (c == 0x8E)
+    {
+        _EUCJP.Remaining = 1;
+        _EUCJP.Hi = 0xDF;
+    }
+    else
+    if (c == 0x8F)
+        _EUCJP.Remaining = 2;
+    else
+    if ((c >= 0xA1) && (c <= 0xFE))
+        _EUCJP.Remaining = 1;
+    else
+        _Candidates &= ~EUCJPBit;
+}
+
+/// <summary>
+/// Detects the encoding of the specified text.
+/// </summary>
+encoding_t DetectEncoding(const char * text, size_t size) noexcept
+{
+    encoding_detector_t Detector;
+
+    Detector.Feed(text, size);
+    Detector.Finish();
+
+    return Detector.GetEncoding();
+}
@@ -0,0 +1,95 @@
+
+/** $VER: EncodingDetector.h (2026.10.17) P. Stuer - Detects the encoding of a text in a single pass. **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// The encodings recognized by the detector.
+/// </summary>
+enum class encoding_t : uint32_t
+{
+    Unknown = 0,
+    ASCII,
+    UTF8,
+    ShiftJIS,
+    EUCJP,
+};
+
+/// <summary>
+/// Detects the encoding of a text by running the state machines of all candidate encodings side by side over the same bytes.
+/// A candidate is eliminated by the first byte sequence it can't decode, or by a character that is cut off at the end of the text; the remaining ones score points for each character that is common in that encoding.
+/// The text can be fed in chunks. Once a single candidate is left only its state machine runs, and detection stops as soon as no candidate is left.
+/// </summary>
+class encoding_detector_t
+{
+public:
+    encoding_detector_t() noexcept : _Candidates(AllCandidates), _IsFinished(), _UTF8(), _ShiftJIS(), _EUCJP() { }
+
+    encoding_detector_t(const encoding_detector_t &) = delete;
+    encoding_detector_t & operator=(const encoding_detector_t &) = delete;
+    encoding_detector_t(encoding_detector_t &&) = delete;
+    encoding_detector_t & operator=(encoding_detector_t &&) = delete;
+
+    void Feed(const char * data, size_t size) noexcept;
+    void Finish() noexcept;
+
+    /// <summary>
+    /// Returns true if more data can't change the result. A single candidate can still be eliminated by the rest of the text, so the detector is only done when none is left.
+    /// </summary>
+    bool IsDone() const noexcept { return _IsFinished || (_Candidates == 0); }
+
+    bool IsCandidate(encoding_t encoding) const noexcept { return (_Candidates & GetBit(encoding)) != 0; }
+
+    encoding_t GetEncoding() const noexcept;
+
+private:
+    static constexpr uint32_t GetBit(encoding_t encoding) noexcept { return (encoding != encoding_t::Unknown) ? 1u << ((uint32_t) encoding - 1) : 0u; }
+
+    static constexpr uint32_t ASCIIBit     = 1u << ((uint32_t) encoding_t::ASCII - 1);
+    static constexpr uint32_t UTF8Bit      = 1u << ((uint32_t) encoding_t::UTF8 - 1);
+    static constexpr uint32_t ShiftJISBit  = 1u << ((uint32_t) encoding_t::ShiftJIS - 1);
+    static constexpr uint32_t EUCJPBit     = 1u << ((uint32_t) encoding_t::EUCJP - 1);
+    static constexpr uint32_t AllCandidates = ASCIIBit | UTF8Bit | ShiftJISBit | EUCJPBit;
+
+    /// <summary>
+    /// Returns true if a remaining candidate is in the middle of a character. The state of an eliminated candidate doesn't matter.
+    /// </summary>
+    bool IsPending() const noexcept
+    {
+        return (((_Candidates & UTF8Bit) != 0) && (_UTF8.Remaining != 0)) || (((_Candidates & ShiftJISBit) != 0) && (_ShiftJIS.Lead != 0)) || (((_Candidates & EUCJPBit) != 0) && (_EUCJP.Remaining != 0));
+    }
+
+    void FeedUTF8(uint8_t c) noexcept;
+    void FeedShiftJIS(uint8_t c) noexcept;
+    void FeedEUCJP(uint8_t c) noexcept;
+
+private:
+    uint32_t _Candidates;
+    bool _IsFinished;
+
+    struct
+    {
+        uint32_t Remaining; // Number of continuation bytes still expected.
+        uint8_t Lo, Hi;     // Range of the next continuation byte.
+        uint32_t Score;
+    } _UTF8;
+
+    struct
+    {
+        uint8_t Lead;       // The lead byte of the pending double-byte character, 0 if none.
+        uint32_t Score;
+    } _ShiftJIS;
+
+    struct
+    {
+        uint32_t Remaining; // Number of bytes still expected.
+        uint8_t Lead;
+        uint8_t Lo, Hi;     // Range of the next byte.
+        uint32_t Score;
+    } _EUCJP;
+};
+
+encoding_t DetectEncoding(const char * text, size_t size) noexcept;
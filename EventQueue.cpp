@@ -0,0 +1,269 @@
+
+/** $VER: EventQueue.cpp (2026.10.17) P. Stuer - Coalesces the events sent to the template. **/
+
+#include "EventQueue.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+const event_clock_t event_queue_t::DefaultClock;
+
+/// <summary>
+/// Adds an event to the queue. A pending event of the same type is superseded by the new one.
+/// </summary>
+void event_queue_t::Enqueue(event_type_t type, const std::wstring & call) noexcept
+{
+    slot_t & Slot = _Slots[(size_t) type];
+
+    ++Slot.Counters.Received;
+
+    if (!_IsHolding && !IsSubscribed(type))
+    {
+        ++Slot.Counters.Dropped;
+        return;
+    }
+
+    Slot.Call = call;
+    Slot.Sequence = ++_Sequence;
+
+    if (Slot.IsPending)
+    {
+        ++Slot.Counters.Coalesced;
+        return;
+    }
+
+    Slot.Time = _Clock.Now();
+    Slot.IsPending = true;
+    Slot.IsDeferred = false;
+
+    ++_PendingCount;
+
+    if (!_IsHolding)
+        _Sink.RequestFlush();
+}
+
+/// <summary>
+/// Sends all pending events to the template as a single script, in the order they were last received with the ambient events last.
+/// Ambient events that were sent less than the throttle interval ago stay pending and are sent by a delayed flush.
+/// </summary>
+void event_queue_t::Flush() noexcept
+{
+    if (_IsHolding || (_PendingCount == 0))
+        return;
+
+    const auto Now = _Clock.Now();
+
+    std::vector<slot_t *> Slots;
+
+    Slots.reserve(_PendingCount);
+
+    auto NextFlush = std::chrono::milliseconds::max();
+
+    for (auto & Slot : _Slots)
+    {
+        if (!Slot.IsPending)
+            continue;
+
+        if ((_ThrottleInterval.count() != 0) && (GetPriority((event_type_t) (&Slot - _Slots.data())) == event_priority_t::Ambient))
+        {
+            const auto Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Now - Slot.DispatchTime);
+
+            if (Elapsed < _ThrottleInterval)
+            {
+                if (!Slot.IsDeferred)
+                {
+                    ++Slot.Counters.Deferred;
+
+                    Slot.IsDeferred = true;
+                }
+
+                NextFlush = (std::min)(NextFlush, _ThrottleInterval - Elapsed);
+                continue;
+            }
+        }
+
+        Slots.push_back(&Slot);
+    }
+
+    if (NextFlush != std::chrono::milliseconds::max())
+        _Sink.RequestDelayedFlush((uint32_t) (std::max)(NextFlush.count(), (std::chrono::milliseconds::rep) 1));
+
+    if (Slots.empty())
+        return;
+
+    // Sort by arrival with the ambient events last. Reordering the other events could e.g. send a stop before the pause that preceded it.
+    std::sort(Slots.begin(), Slots.end(), [this](const slot_t * a, const slot_t * b) { return GetSortKey(a) < GetSortKey(b); });
+
+    // Each call is guarded so that an exception in one callback does not prevent the others from running.
+    std::wstring Script;
+    std::vector<dispatched_event_t> Events;
+
+    Events.reserve(Slots.size());
+
+    for (auto * Slot : Slots)
+    {
+        Script.append(L"try { ").append(Slot->Call).append(L"; } catch (e) { console.error(e); }\n");
+
+        Events.push_back({ (event_type_t) (Slot - _Slots.data()), Slot->Time });
+
+        ++Slot->Counters.Dispatched;
+
+        Slot->Call.clear();
+        Slot->DispatchTime = Now;
+        Slot->IsPending = false;
+    }
+
+    _PendingCount -= Slots.size();
+
+    if (_Sink.ExecuteScript(Script, Events, { _Epoch, Now }))
+    {
+        ++_ScriptsExecuted;
+        ++_ScriptsInFlight;
+
+        UpdateThrottle();
+    }
+}
+
+/// <summary>
+/// Updates the in-flight count and the latency estimate when the page has executed a script. Scripts submitted before the queue was cleared are ignored.
+/// </summary>
+void event_queue_t::OnScriptCompleted(const script_ticket_t & ticket) noexcept
+{
+    if ((ticket.Epoch != _Epoch) || (_ScriptsInFlight == 0))
+        return;
+
+    --_ScriptsInFlight;
+
+    const auto Latency = std::chrono::duration_cast<std::chrono::microseconds>(_Clock.Now() - ticket.SubmitTime);
+
+    _Latency = (_Latency * 3 + Latency) / 4;
+
+    UpdateThrottle();
+}
+
+/// <summary>
+/// Doubles the throttle interval of the low priority events while the page is congested and halves it once it keeps up again.
+/// The interval changes at most once per measurement window so that a burst of flushes or completions counts as a single observation.
+/// </summary>
+void event_queue_t::UpdateThrottle() noexcept
+{
+    const auto Now = _Clock.Now();
+
+    if ((_ThrottleTime != event_time_t::min()) && (Now - _ThrottleTime < MeasurementWindow))
+        return;
+
+    const bool IsCongested = (_ScriptsInFlight > MaxScriptsInFlight) || (_Latency > LatencyBudget);
+
+    const auto Interval = IsCongested ? (std::min)((std::max)(_ThrottleInterval * 2, MinThrottleInterval), MaxThrottleInterval)
+                                      : ((_ThrottleInterval / 2 >= MinThrottleInterval) ? _ThrottleInterval / 2 : std::chrono::milliseconds(0));
+
+    if (Interval == _ThrottleInterval)
+        return;
+
+    _ThrottleInterval = Interval;
+    _ThrottleTime = Now;
+}
+
+/// <summary>
+/// Gets the lane of an event type.
+/// </summary>
+event_priority_t event_queue_t::GetPriority(event_type_t type) noexcept
+{
+    static const event_priority_t Priorities[] =
+    {
+        event_priority_t::Critical,     // PlaybackStarting
+        event_priority_t::Critical,     // PlaybackNewTrack
+        event_priority_t::Critical,     // PlaybackStop
+        event_priority_t::Interactive,  // PlaybackSeek
+        event_priority_t::Interactive,  // PlaybackPause
+        event_priority_t::Interactive,  // PlaybackEdited
+        event_priority_t::Ambient,      // PlaybackDynamicInfo
+        event_priority_t::Interactive,  // PlaybackDynamicTrackInfo
+        event_priority_t::Ambient,      // PlaybackTime
+        event_priority_t::Ambient,      // VolumeChange
+        event_priority_t::Interactive,  // PlaylistFocusedItemChanged
+    };
+
+    static_assert(std::size(Priorities) == (size_t) event_type_t::Count, "Priority table is out of sync with event_type_t");
+
+    return Priorities[(size_t) type];
+}
+
+/// <summary>
+/// Gets the total number of events received.
+/// </summary>
+uint64_t event_queue_t::GetEventsReceived() const noexcept
+{
+    uint64_t Count = 0;
+
+    for (const auto & Slot : _Slots)
+        Count += Slot.Counters.Received;
+
+    return Count;
+}
+
+/// <summary>
+/// Sets the events the template handles and sends the events that were held for it. Events that are not subscribed to are discarded.
+/// </summary>
+void event_queue_t::SetSubscriptions(uint32_t mask) noexcept
+{
+    _Subscriptions = mask & AllEvents;
+    _IsHolding = false;
+
+    for (auto & Slot : _Slots)
+    {
+        if (!Slot.IsPending || IsSubscribed((event_type_t) (&Slot - _Slots.data())))
+            continue;
+
+        ++Slot.Counters.Dropped;
+
+        Slot.Call.clear();
+        Slot.IsPending = false;
+
+        --_PendingCount;
+    }
+
+    if (_PendingCount != 0)
+        _Sink.RequestFlush();
+}
+
+/// <summary>
+/// Holds the events until a new page has subscribed to them. Only the latest event of each type is kept. Scripts that were submitted to the previous page are forgotten.
+/// </summary>
+void event_queue_t::Hold() noexcept
+{
+    _Subscriptions = 0;
+    _IsHolding = true;
+
+    ResetThrottle();
+}
+
+/// <summary>
+/// Discards all pending events and holds the new ones until a new page has subscribed to them.
+/// </summary>
+void event_queue_t::Clear() noexcept
+{
+    for (auto & Slot : _Slots)
+    {
+        Slot.Call.clear();
+        Slot.IsPending = false;
+    }
+
+    _PendingCount = 0;
+
+    Hold();
+}
+
+/// <summary>
+/// Starts a new epoch and forgets the scripts in flight and the latency of the previous page.
+/// </summary>
+void event_queue_t::ResetThrottle() noexcept
+{
+    ++_Epoch;
+
+    _ScriptsInFlight = 0;
+    _Latency = std::chrono::microseconds(0);
+    _ThrottleInterval = std::chrono::milliseconds(0);
+    _ThrottleTime = event_time_t::min();
+}
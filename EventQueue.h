@@ -0,0 +1,212 @@
+
+/** $VER: EventQueue.h (2026.10.17) P. Stuer - Coalesces the events sent to the template. **/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Identifies the events that can be sent to the template.
+/// </summary>
+enum class event_type_t : size_t
+{
+    PlaybackStarting = 0,
+    PlaybackNewTrack,
+    PlaybackStop,
+    PlaybackSeek,
+    PlaybackPause,
+    PlaybackEdited,
+    PlaybackDynamicInfo,
+    PlaybackDynamicTrackInfo,
+    PlaybackTime,
+    VolumeChange,
+    PlaylistFocusedItemChanged,
+
+    Count
+};
+
+/// <summary>
+/// Identifies the lane of an event. Critical and interactive events are sent in the order they arrived because they are often causally linked, e.g. a seek followed by a new track. Ambient events are sent after them.
+/// </summary>
+enum class event_priority_t : uint32_t
+{
+    Critical = 0,   // New track, stop, playback starting. Never delayed.
+    Interactive,    // Seek, pause, tag changes and selection changes. Never delayed.
+    Ambient,        // Time, volume and dynamic info. Delayed when the page does not keep up.
+
+    Count
+};
+
+typedef std::chrono::steady_clock::time_point event_time_t;
+
+/// <summary>
+/// Provides the time to the event queue. Can be replaced by a simulated clock to drive the queue without real time passing.
+/// </summary>
+class event_clock_t
+{
+public:
+    virtual ~event_clock_t() { }
+
+    virtual event_time_t Now() const noexcept { return std::chrono::steady_clock::now(); }
+};
+
+/// <summary>
+/// Describes an event that was sent to the template.
+/// </summary>
+struct dispatched_event_t
+{
+    event_type_t Type;
+    event_time_t Time;      // The time the event became pending.
+};
+
+/// <summary>
+/// Identifies a script executed by the event queue. Handed back to the queue when the page has executed the script.
+/// </summary>
+struct script_ticket_t
+{
+    uint64_t Epoch;         // The epoch of the queue when the script was submitted. Scripts submitted before the queue was cleared are ignored.
+    event_time_t SubmitTime;
+};
+
+/// <summary>
+/// Receives the output of the event queue. Implemented by the UI element; can be faked to drive the queue without a WebView.
+/// </summary>
+class event_sink_t
+{
+public:
+    virtual ~event_sink_t() { }
+
+    /// <summary>
+    /// Asks the owner to call event_queue_t::Flush() during the next turn of the UI loop.
+    /// </summary>
+    virtual void RequestFlush() noexcept = 0;
+
+    /// <summary>
+    /// Asks the owner to call event_queue_t::Flush() after the specified delay.
+    /// </summary>
+    virtual void RequestDelayedFlush(uint32_t milliseconds) noexcept = 0;
+
+    /// <summary>
+    /// Executes the specified script that contains the calls of the specified events. Returns false if the script could not be executed.
+    /// The owner must call event_queue_t::OnScriptCompleted() with the specified ticket once the page has executed the script.
+    /// </summary>
+    virtual bool ExecuteScript(const std::wstring & script, const std::vector<dispatched_event_t> & events, const script_ticket_t & ticket) noexcept = 0;
+};
+
+/// <summary>
+/// Implements a queue that merges superseded events and sends them to the template as one script per flush.
+/// Each event type has a single slot, so a new event of any type replaces the pending one of the same type.
+/// The critical and interactive events are sent in the order they were last received, followed by the ambient events in the order they were last received.
+/// The queue depends only on the standard library; the clock and the sink can be replaced to test it on any platform.
+/// When the page does not keep up (too many scripts in flight or a high completion latency) the events in the ambient lane are sent less often.
+/// While there is no page to send them to, e.g. before the WebView has been created or while a template is loading, the latest event of each type is held until the page has subscribed to them.
+/// </summary>
+class event_queue_t
+{
+public:
+    event_queue_t(event_sink_t & sink, const event_clock_t & clock = DefaultClock) noexcept : _Sink(sink), _Clock(clock), _Slots(), _Subscriptions(), _IsHolding(true), _Sequence(), _PendingCount(), _ScriptsExecuted(), _Epoch(), _ScriptsInFlight(), _Latency(), _ThrottleInterval(), _ThrottleTime(event_time_t::min()) { }
+
+    event_queue_t(const event_queue_t &) = delete;
+    event_queue_t & operator=(const event_queue_t &) = delete;
+    event_queue_t(event_queue_t &&) = delete;
+    event_queue_t & operator=(event_queue_t &&) = delete;
+
+    void Enqueue(event_type_t type, const std::wstring & call) noexcept;
+    void Flush() noexcept;
+    void Hold() noexcept;
+    void Clear() noexcept;
+
+    void OnScriptCompleted(const script_ticket_t & ticket) noexcept;
+
+    bool IsEmpty() const noexcept { return _PendingCount == 0; }
+
+    event_time_t Now() const noexcept { return _Clock.Now(); }
+
+    static event_priority_t GetPriority(event_type_t type) noexcept;
+
+    /// <summary>
+    /// Gets the minimum interval between two ambient events of the same type. Zero if the page keeps up.
+    /// </summary>
+    std::chrono::milliseconds GetThrottleInterval() const noexcept { return _ThrottleInterval; }
+
+    /// <summary>
+    /// Gets the number of scripts that were submitted but not executed by the page yet.
+    /// </summary>
+    size_t GetScriptsInFlight() const noexcept { return _ScriptsInFlight; }
+
+    void SetSubscriptions(uint32_t mask) noexcept;
+
+    bool IsSubscribed(event_type_t type) const noexcept { return (_Subscriptions & (1u << (uint32_t) type)) != 0; }
+
+    static const uint32_t AllEvents = (1u << (uint32_t) event_type_t::Count) - 1;
+
+    /// <summary>
+    /// Counts what happened to the events of one type.
+    /// </summary>
+    struct counters_t
+    {
+        uint64_t Received;
+        uint64_t Dropped;       // Not subscribed to by the template.
+        uint64_t Coalesced;     // Superseded by a newer event of the same type before being sent.
+        uint64_t Deferred;      // Held back at least once because the page did not keep up.
+        uint64_t Dispatched;
+    };
+
+    const counters_t & GetCounters(event_type_t type) const noexcept { return _Slots[(size_t) type].Counters; }
+
+    uint64_t GetEventsReceived() const noexcept;
+    uint64_t GetScriptsExecuted() const noexcept { return _ScriptsExecuted; }
+
+private:
+    struct slot_t
+    {
+        std::wstring Call;
+        uint64_t Sequence;
+        event_time_t Time;
+        event_time_t DispatchTime;  // The last time an event of this type was sent.
+        bool IsPending;
+        bool IsDeferred;            // The pending event has been held back at least once.
+
+        counters_t Counters;
+    };
+
+    static const event_clock_t DefaultClock;
+
+    event_sink_t & _Sink;
+    const event_clock_t & _Clock;
+
+    std::array<slot_t, (size_t) event_type_t::Count> _Slots;
+
+    uint32_t _Subscriptions;
+    bool _IsHolding;                                    // True while there is no page that subscribed to the events.
+
+    uint64_t _Sequence;
+    size_t _PendingCount;
+
+    uint64_t _ScriptsExecuted;
+
+    uint64_t GetSortKey(const slot_t * slot) const noexcept
+    {
+        return ((uint64_t) (GetPriority((event_type_t) (slot - _Slots.data())) == event_priority_t::Ambient) << 56) | slot->Sequence;
+    }
+
+    // Backpressure
+    void UpdateThrottle() noexcept;
+    void ResetThrottle() noexcept;
+
+    static constexpr size_t MaxScriptsInFlight = 2;
+    static constexpr std::chrono::microseconds LatencyBudget = std::chrono::milliseconds(50);
+    static constexpr std::chrono::milliseconds MinThrottleInterval = std::chrono::milliseconds(250);
+    static constexpr std::chrono::milliseconds MaxThrottleInterval = std::chrono::milliseconds(2000);
+    static constexpr std::chrono::milliseconds MeasurementWindow = std::chrono::milliseconds(500);  // The throttle interval changes at most once per window.
+
+    uint64_t _Epoch;                                    // Incremented each time the queue starts waiting for a new page.
+    size_t _ScriptsInFlight;
+    std::chrono::microseconds _Latency;                 // Moving average of the script completion latency.
+    std::chrono::milliseconds _ThrottleInterval;
+    event_time_t _ThrottleTime;                         // The last time the throttle interval changed.
+};
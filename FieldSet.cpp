@@ -0,0 +1,83 @@
+
+/** $VER: FieldSet.cpp (2026.10.17) P. Stuer - Maintains the fields registered by the template. **/
+
+#include "pch.h"
+
+#include "FieldSet.h"
+#include "Encoding.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Replaces the registered fields. The index of a text is used to identify its field in the messages sent to the page.
+/// </summary>
+void field_set_t::Register(const std::vector<std::wstring> & texts) noexcept
+{
+    _Fields.clear();
+    _Fields.reserve(texts.size());
+
+    _Classes = 0;
+
+    for (const auto & Text : texts)
+    {
+        pfc::string8 UTF8Text = ::WideToUTF8(Text).c_str();
+
+        const text_class_t Class = ::GetTextClass(UTF8Text.c_str());
+
+        _Fields.push_back({ UTF8Text, "", Class, false });
+
+        _Classes |= (uint32_t) Class;
+    }
+}
+
+/// <summary>
+/// Removes all fields.
+/// </summary>
+void field_set_t::Clear() noexcept
+{
+    _Fields.clear();
+
+    _Classes = 0;
+}
+
+/// <summary>
+/// Formats the fields of the specified classes and returns the ones that changed since the previous update as a JSON message: { "type": "fields", "values": { "<index>": "<text>", ... } }.
+/// Returns an empty string if no field changed.
+/// </summary>
+std::wstring field_set_t::GetUpdate(const formatter_t & formatter, uint32_t classes) noexcept
+{
+    std::wstring JSON;
+
+    pfc::string8 FormattedText;
+
+    for (size_t i = 0; i < _Fields.size(); ++i)
+    {
+        field_t & Field = _Fields[i];
+
+        if (((uint32_t) Field.Class & classes) == 0)
+            continue;
+
+        FormattedText.reset();
+
+        (void) formatter.Format(Field.Text, FormattedText); // A text that fails to compile results in an empty string.
+
+        if (Field.IsSent && (::strcmp(Field.Value.c_str(), FormattedText.c_str()) == 0))
+        {
+            ++_FieldsSuppressed;
+            continue;
+        }
+
+        Field.Value = FormattedText;
+        Field.IsSent = true;
+
+        ++_FieldsSent;
+
+        JSON.append(JSON.empty() ? L"{\"type\":\"fields\",\"values\":{" : L",");
+        JSON.append(L"\"").append(std::to_wstring(i)).append(L"\":").append(::ToJSONString(::UTF8ToWide(FormattedText.c_str(), FormattedText.length())));
+    }
+
+    if (!JSON.empty())
+        JSON.append(L"}}");
+
+    return JSON;
+}
@@ -0,0 +1,55 @@
+
+/** $VER: FieldSet.h (2026.10.17) P. Stuer - Maintains the fields registered by the template. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include "Formatter.h"
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Maintains the Title Formatting texts registered by the template. The host formats them and pushes the results to the page.
+/// </summary>
+class field_set_t
+{
+public:
+    field_set_t() : _Classes(), _FieldsSent(), _FieldsSuppressed() { }
+
+    field_set_t(const field_set_t &) = delete;
+    field_set_t & operator=(const field_set_t &) = delete;
+    field_set_t(field_set_t &&) = delete;
+    field_set_t & operator=(field_set_t &&) = delete;
+
+    void Register(const std::vector<std::wstring> & texts) noexcept;
+    void Clear() noexcept;
+
+    bool IsEmpty() const noexcept { return _Fields.empty(); }
+
+    /// <summary>
+    /// Returns true if at least one field belongs to one of the specified classes.
+    /// </summary>
+    bool HasClasses(uint32_t classes) const noexcept { return (_Classes & classes) != 0; }
+
+    std::wstring GetUpdate(const formatter_t & formatter, uint32_t classes) noexcept;
+
+    uint64_t GetFieldsSent() const noexcept { return _FieldsSent; }
+    uint64_t GetFieldsSuppressed() const noexcept { return _FieldsSuppressed; }
+
+private:
+    struct field_t
+    {
+        pfc::string8 Text;
+        pfc::string8 Value;     // The last value sent to the page.
+        text_class_t Class;
+        bool IsSent;
+    };
+
+    std::vector<field_t> _Fields;
+    uint32_t _Classes;          // The classes of all registered fields.
+
+    uint64_t _FieldsSent;
+    uint64_t _FieldsSuppressed;
+};
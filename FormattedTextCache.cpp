@@ -0,0 +1,210 @@
+
+/** $VER: FormattedTextCache.cpp (2026.10.17) P. Stuer - Caches the results of Title Formatting texts per track. **/
+
+#include "pch.h"
+
+#include "FormattedTextCache.h"
+
+#include <SDK/initquit.h>
+#include <SDK/metadb_callbacks.h>
+
+#include <algorithm>
+
+#pragma hdrstop
+
+formatted_text_cache_t _FormattedTextCache(1024);
+
+/// <summary>
+/// Gets the cached result of the specified text for the specified track. Returns false if the result is not in the cache.
+/// </summary>
+bool formatted_text_cache_t::Get(const metadb_handle_ptr & track, t_size playlistIndex, t_size itemIndex, const pfc::string8 & text, pfc::string8 & formattedText) noexcept
+{
+    if (track.is_empty())
+        return false;
+
+    auto Item = _Index.find({ track.get_ptr(), playlistIndex, itemIndex, std::string(text.c_str(), text.length()) });
+
+    if (Item == _Index.end())
+    {
+        ++_Misses;
+
+        return false;
+    }
+
+    ++_Hits;
+
+    _Entries.splice(_Entries.begin(), _Entries, Item->second);
+
+    formattedText = Item->second->FormattedText;
+
+    return true;
+}
+
+/// <summary>
+/// Adds the result of the specified text for the specified track to the cache, if the text can be cached.
+/// </summary>
+void formatted_text_cache_t::Put(const metadb_handle_ptr & track, t_size playlistIndex, t_size itemIndex, const pfc::string8 & text, const pfc::string8 & formattedText) noexcept
+{
+    text_class_t Class;
+
+    if (track.is_empty() || !IsCacheable(text, Class))
+        return;
+
+    key_t Key = { track.get_ptr(), playlistIndex, itemIndex, std::string(text.c_str(), text.length()) };
+
+    auto Item = _Index.find(Key);
+
+    if (Item != _Index.end())
+        Erase(Item->second);
+
+    if (_Entries.size() >= _Capacity)
+        Erase(std::prev(_Entries.end()));
+
+    _Entries.push_front({ Key, track, Class, formattedText });
+    _Index[std::move(Key)] = _Entries.begin();
+}
+
+/// <summary>
+/// Removes the results of the specified track from the cache.
+/// </summary>
+void formatted_text_cache_t::Invalidate(const metadb_handle_ptr & track) noexcept
+{
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end();)
+    {
+        auto Next = std::next(Entry);
+
+        if (Entry->Track == track)
+            Erase(Entry);
+
+        Entry = Next;
+    }
+}
+
+/// <summary>
+/// Removes the results of the specified tracks from the cache. The list must be sorted by pointer.
+/// </summary>
+void formatted_text_cache_t::Invalidate(metadb_handle_list_cref sortedTracks) noexcept
+{
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end();)
+    {
+        auto Next = std::next(Entry);
+
+        if (sortedTracks.bsearch_by_pointer(Entry->Track) < sortedTracks.get_count())
+            Erase(Entry);
+
+        Entry = Next;
+    }
+}
+
+/// <summary>
+/// Removes the results that can be changed by an event of the specified class from the cache.
+/// </summary>
+void formatted_text_cache_t::Invalidate(text_class_t eventClass) noexcept
+{
+    const uint32_t Classes = GetAffectedClasses(eventClass);
+
+    if ((Classes & (uint32_t) text_class_t::Static) != 0)
+    {
+        Clear();
+
+        return;
+    }
+
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end();)
+    {
+        auto Next = std::next(Entry);
+
+        if ((Classes & (uint32_t) Entry->Class) != 0)
+            Erase(Entry);
+
+        Entry = Next;
+    }
+}
+
+/// <summary>
+/// Removes all entries from the cache.
+/// </summary>
+void formatted_text_cache_t::Clear() noexcept
+{
+    _Index.clear();
+    _Entries.clear();
+}
+
+/// <summary>
+/// Returns true if the result of the specified text only changes when the track, its tags, its dynamic info or its playlist location change.
+/// </summary>
+bool formatted_text_cache_t::IsCacheable(const char * text, text_class_t & textClass) noexcept
+{
+    textClass = GetTextClass(text);
+
+    if (textClass == text_class_t::Time)
+        return false;
+
+    // Fields and functions that change without any notification to the panel.
+    static const char * const VolatileFields[] =
+    {
+        "$rand(",
+        "%playlist_name%",
+        "%queue_",          // %queue_index%, %queue_indexes%, %queue_total%
+        "%list_total%",
+        "%cwb_",            // Date and time functions of foo_cwb_hooks
+        "%now",
+    };
+
+    std::string Text(text);
+
+    std::transform(Text.begin(), Text.end(), Text.begin(), [](char c) { return (char) ::tolower((unsigned char) c); });
+
+    for (const auto & Field : VolatileFields)
+        if (Text.find(Field) != std::string::npos)
+            return false;
+
+    return true;
+}
+
+/// <summary>
+/// Removes an entry from the cache.
+/// </summary>
+void formatted_text_cache_t::Erase(std::list<entry_t>::iterator entry) noexcept
+{
+    _Index.erase(entry->Key);
+    _Entries.erase(entry);
+}
+
+namespace
+{
+    /// <summary>
+    /// Removes the results of the tracks whose information changed from the cache.
+    /// </summary>
+    class formatted_text_cache_callback_t : public metadb_io_callback_dynamic
+    {
+    public:
+        void on_changed_sorted(metadb_handle_list_cref tracks, bool) override
+        {
+            _FormattedTextCache.Invalidate(tracks);
+        }
+    };
+
+    static formatted_text_cache_callback_t _Callback;
+
+    /// <summary>
+    /// Registers the metadb callback when foobar2000 starts and empties the cache when it shuts down.
+    /// </summary>
+    class formatted_text_cache_initquit_t : public initquit
+    {
+    public:
+        void on_init() noexcept override
+        {
+            metadb_io_v3::get()->register_callback(&_Callback);
+        }
+
+        void on_quit() noexcept override
+        {
+            metadb_io_v3::get()->unregister_callback(&_Callback);
+
+            _FormattedTextCache.Clear();
+        }
+    };
+
+    static initquit_factory_t<formatted_text_cache_initquit_t> _InitQuitFactory;
+}
@@ -0,0 +1,93 @@
+
+/** $VER: FormattedTextCache.h (2026.10.17) P. Stuer - Caches the results of Title Formatting texts per track. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <SDK/metadb.h>
+
+#include "Formatter.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// Implements a bounded LRU cache of formatted texts, keyed by track, playlist location and text, shared by all instances of the panel. Must be used from the main thread.
+/// Texts that depend on the playback time or that change without a notification are never cached. The other texts stay cached until their track or its dynamic info changes.
+/// </summary>
+class formatted_text_cache_t
+{
+public:
+    formatted_text_cache_t(size_t capacity) noexcept : _Capacity(capacity), _Hits(), _Misses() { }
+
+    formatted_text_cache_t(const formatted_text_cache_t &) = delete;
+    formatted_text_cache_t & operator=(const formatted_text_cache_t &) = delete;
+    formatted_text_cache_t(formatted_text_cache_t &&) = delete;
+    formatted_text_cache_t & operator=(formatted_text_cache_t &&) = delete;
+
+    bool Get(const metadb_handle_ptr & track, t_size playlistIndex, t_size itemIndex, const pfc::string8 & text, pfc::string8 & formattedText) noexcept;
+    void Put(const metadb_handle_ptr & track, t_size playlistIndex, t_size itemIndex, const pfc::string8 & text, const pfc::string8 & formattedText) noexcept;
+
+    void Invalidate(const metadb_handle_ptr & track) noexcept;
+    void Invalidate(metadb_handle_list_cref sortedTracks) noexcept;
+    void Invalidate(text_class_t eventClass) noexcept;
+    void Clear() noexcept;
+
+    size_t GetCount() const noexcept { return _Entries.size(); }
+
+    uint64_t GetHits() const noexcept { return _Hits; }
+    uint64_t GetMisses() const noexcept { return _Misses; }
+
+private:
+    struct key_t
+    {
+        const metadb_handle * Track;
+        t_size PlaylistIndex;
+        t_size ItemIndex;
+        std::string Text;
+
+        bool operator==(const key_t & other) const noexcept
+        {
+            return (Track == other.Track) && (PlaylistIndex == other.PlaylistIndex) && (ItemIndex == other.ItemIndex) && (Text == other.Text);
+        }
+    };
+
+    struct key_hash_t
+    {
+        size_t operator()(const key_t & key) const noexcept
+        {
+            size_t Hash = std::hash<std::string>()(key.Text);
+
+            Hash ^= std::hash<const void *>()(key.Track) + 0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+            Hash ^= std::hash<t_size>()(key.ItemIndex) + 0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+            Hash ^= std::hash<t_size>()(key.PlaylistIndex) + 0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+
+            return Hash;
+        }
+    };
+
+    struct entry_t
+    {
+        key_t Key;
+        metadb_handle_ptr Track;    // Keeps the track alive as long as its address is used as a key.
+        text_class_t Class;
+        pfc::string8 FormattedText;
+    };
+
+    static bool IsCacheable(const char * text, text_class_t & textClass) noexcept;
+
+    void Erase(std::list<entry_t>::iterator entry) noexcept;
+
+private:
+    size_t _Capacity;
+
+    std::list<entry_t> _Entries; // Most recently used entry first.
+    std::unordered_map<key_t, std::list<entry_t>::iterator, key_hash_t> _Index;
+
+    uint64_t _Hits;
+    uint64_t _Misses;
+};
+
+extern formatted_text_cache_t _FormattedTextCache;
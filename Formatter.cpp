@@ -0,0 +1,124 @@
+
+/** $VER: Formatter.cpp (2026.10.17) P. Stuer - Formats the current track using Title Formatting texts. **/
+
+#include "pch.h"
+
+#include "Formatter.h"
+#include "TitleFormatCache.h"
+#include "CurrentTrack.h"
+#include "FormattedTextCache.h"
+#include "Configuration.h"
+#include "Encoding.h"
+
+#include <algorithm>
+
+#pragma hdrstop
+
+namespace
+{
+    bool _WasRepairEnabled = false; // The mojibake repair setting used by the previous formatter.
+}
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+formatter_t::formatter_t() noexcept : _PlaylistManager(playlist_manager::get()), _PlaylistIndex(~0u), _ItemIndex(~0u), _Generation(), _IsRepairEnabled(RepairMojibakeCfg.get())
+{
+    _CurrentTrack.Get(_PlaylistIndex, _ItemIndex, _Track);
+
+    _Generation = _CurrentTrack.GetGeneration();
+
+    // The cached texts were formatted with the other setting.
+    if (_IsRepairEnabled != _WasRepairEnabled)
+    {
+        _FormattedTextCache.Clear();
+
+        _WasRepairEnabled = _IsRepairEnabled;
+    }
+}
+
+/// <summary>
+/// Formats the track using the specified text containing Title Formating instructions. Mis-decoded Japanese text in the result is repaired if enabled in the advanced preferences.
+/// </summary>
+HRESULT formatter_t::Format(const pfc::string8 & text, pfc::string8 & formattedText) const noexcept
+{
+    if (_FormattedTextCache.Get(_Track, _PlaylistIndex, _ItemIndex, text, formattedText))
+        return S_OK;
+
+    titleformat_object::ptr FormatObject;
+
+    if (!_TitleFormatCache.Get(text, FormatObject))
+        return E_INVALIDARG;
+
+    _PlaylistManager->playlist_item_format_title(_PlaylistIndex, _ItemIndex, nullptr, formattedText, FormatObject, nullptr, playback_control::t_display_level::display_level_all);
+
+    if (_IsRepairEnabled && _Repairer.Repair(formattedText.c_str(), formattedText.length(), _RepairedText))
+        formattedText.set_string(_RepairedText.c_str(), _RepairedText.length());
+
+    // Don't cache a result that may belong to another item than the track it would be stored under.
+    if (!IsStale())
+        _FormattedTextCache.Put(_Track, _PlaylistIndex, _ItemIndex, text, formattedText);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Formats the track using the specified text containing Title Formating instructions. Returns E_INVALIDARG if the text contains an unpaired surrogate.
+/// </summary>
+HRESULT formatter_t::Format(const wchar_t * text, size_t size, std::wstring & formattedText) const noexcept
+{
+    std::string Text;
+
+    if (!::TryWideToUTF8(text, size, Text))
+        return E_INVALIDARG;
+
+    pfc::string8 FormattedText;
+
+    HRESULT hr = Format(pfc::string8(Text.c_str(), Text.length()), FormattedText);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    formattedText = ::UTF8ToWide(FormattedText.c_str(), FormattedText.length());
+
+    return S_OK;
+}
+
+/// <summary>
+/// Determines the class of the specified Title Formatting text by looking for the fields and functions that depend on the playback time or the dynamic info.
+/// </summary>
+text_class_t GetTextClass(const char * text) noexcept
+{
+    static const char * const TimeFields[] =
+    {
+        "%playback_time",   // %playback_time%, %playback_time_seconds%, %playback_time_remaining%, %playback_time_remaining_seconds%
+        "%isplaying%",
+        "%ispaused%",
+    };
+
+    static const char * const DynamicInfoFields[] =
+    {
+        "$info(",
+        "%__",
+        "%bitrate%",
+        "%codec",           // %codec%, %codec_profile%, %codec_long%
+        "%samplerate%",
+        "%channels%",
+        "%bitspersample%",
+        "%encoding%",
+    };
+
+    std::string Text(text);
+
+    std::transform(Text.begin(), Text.end(), Text.begin(), [](char c) { return (char) ::tolower((unsigned char) c); });
+
+    for (const auto & Field : TimeFields)
+        if (Text.find(Field) != std::string::npos)
+            return text_class_t::Time;
+
+    for (const auto & Field : DynamicInfoFields)
+        if (Text.find(Field) != std::string::npos)
+            return text_class_t::DynamicInfo;
+
+    return text_class_t::Static;
+}
@@ -0,0 +1,70 @@
+
+/** $VER: Formatter.h (2026.10.17) P. Stuer - Formats the current track using Title Formatting texts. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <SDK/playlist.h>
+
+#include "CurrentTrack.h"
+#include "Mojibake.h"
+
+/// <summary>
+/// Classifies a Title Formatting text by the kind of event that can change its result. The classes are ordered from least to most volatile.
+/// </summary>
+enum class text_class_t : uint32_t
+{
+    Static      = 1,    // Changes only when the track or its tags change.
+    DynamicInfo = 2,    // Also changes when the dynamic info of the playing track changes (bitrate, codec, technical info...).
+    Time        = 4,    // Also changes with the playback time or state.
+
+    All         = Static | DynamicInfo | Time
+};
+
+text_class_t GetTextClass(const char * text) noexcept;
+
+/// <summary>
+/// Gets the classes of texts that need to be re-evaluated when an event of the specified class occurs, i.e. the specified class and all more volatile ones.
+/// </summary>
+inline uint32_t GetAffectedClasses(text_class_t eventClass) noexcept
+{
+    return (uint32_t) text_class_t::All & ~((uint32_t) eventClass - 1);
+}
+
+/// <summary>
+/// Formats the current track. The track is taken from the cache when the formatter is created so that all texts formatted by the same instance refer to the same track.
+/// An instance is meant to format a batch of texts: the mojibake repair buffers are shared by all of them.
+/// </summary>
+class formatter_t
+{
+public:
+    formatter_t() noexcept;
+
+    formatter_t(const formatter_t &) = delete;
+    formatter_t & operator=(const formatter_t &) = delete;
+    formatter_t(formatter_t &&) = delete;
+    formatter_t & operator=(formatter_t &&) = delete;
+
+    HRESULT Format(const pfc::string8 & text, pfc::string8 & formattedText) const noexcept;
+    HRESULT Format(const wchar_t * text, size_t size, std::wstring & formattedText) const noexcept;
+
+    const metadb_handle_ptr & GetTrack() const noexcept { return _Track; }
+
+    /// <summary>
+    /// Returns true if the current track has been invalidated since the track was taken from the cache. The playlist and item index may no longer refer to the track.
+    /// </summary>
+    bool IsStale() const noexcept { return _CurrentTrack.GetGeneration() != _Generation; }
+
+private:
+    playlist_manager::ptr _PlaylistManager;
+
+    t_size _PlaylistIndex;
+    t_size _ItemIndex;
+    metadb_handle_ptr _Track;
+    uint64_t _Generation;       // The generation of the current track cache when the track was taken from it.
+
+    bool _IsRepairEnabled;
+    mutable mojibake_repairer_t _Repairer;
+    mutable std::string _RepairedText;
+};
@@ -1,27 +1,21 @@
 
-/** $VER: HostObjectImpl.cpp (2024.06.05) P. Stuer **/
+/** $VER: HostObjectImpl.cpp (2026.10.17) P. Stuer **/
 
 #include "pch.h"
 
 #include "HostObjectImpl.h"
 
-#include <pathcch.h>
-#pragma comment(lib, "pathcch")
-
 #include "Support.h"
+#include "Encoding.h"
 #include "Resources.h"
-
-#include <SDK/titleformat.h>
-#include <SDK/playlist.h>
-#include <SDK/ui.h>
-#include <SDK/contextmenu.h>
-
-#include <pfc/string-conv-lite.h>
+#include "Formatter.h"
+#include "Tracer.h"
 
 /// <summary>
 /// Initializes a new instance
 /// </summary>
-HostObject::HostObject(HostObject::RunCallbackAsync runCallbackAsync) : _RunCallbackAsync(runCallbackAsync)
+HostObject::HostObject(HostObject::RunCallbackAsync runCallbackAsync, HostObject::RegisterFieldsCallback registerFields, HostObject::GetStatisticsCallback getStatistics, statistics_t & statistics, uint32_t traceLane) :
+    _RunCallbackAsync(runCallbackAsync), _RegisterFields(registerFields), _GetStatistics(getStatistics), _Statistics(statistics), _TraceLane(traceLane)
 {
 }
 
@@ -30,164 +24,436 @@ HostObject::HostObject(HostObject::RunCallbackAsync runCallbackAsync) : _RunCall
 /// </summary>
 STDMETHODIMP HostObject::GetFormattedText(BSTR text, BSTR * formattedText)
 {
-    t_size PlaylistIndex = ~0u;
-    t_size ItemIndex = ~0u;
-
-    GetTrackIndex(PlaylistIndex, ItemIndex);
-
-    titleformat_object::ptr FormatObject;
-    pfc::string8 Text = pfc::utf8FromWide(text);
+    trace_scope_t Scope("HostObject.GetFormattedText", _TraceLane);
+    host_call_timer_t Timer(_Statistics, host_method_t::GetFormattedText);
 
-    bool Success = titleformat_compiler::get()->compile(FormatObject, Text);
+    if (formattedText == nullptr)
+        return E_POINTER;
 
-    if (!Success)
-    {
-        console::printf(STR_COMPONENT_NAME " failed to compile \"%s\".", Text.c_str());
+    formatter_t Formatter;
 
-        return E_INVALIDARG;
-    }
+    std::wstring FormattedText;
 
-    static_api_ptr_t<playlist_manager> PlaylistManager;
-    pfc::string8 FormattedText;
+    HRESULT hr = Formatter.Format(text, ::SysStringLen(text), FormattedText);
 
-    PlaylistManager->playlist_item_format_title(PlaylistIndex, ItemIndex, nullptr, FormattedText, FormatObject, nullptr, playback_control::t_display_level::display_level_all);
+    if (!SUCCEEDED(hr))
+        return hr;
 
-    *formattedText = ::SysAllocString(pfc::wideFromUTF8(FormattedText).c_str());
+    *formattedText = ::SysAllocStringLen(FormattedText.c_str(), (UINT) FormattedText.length());
 
-    return S_OK;
+    return (*formattedText != nullptr) ? S_OK : E_OUTOFMEMORY;
 }
 
 /// <summary>
-/// Gets the index of the active playlist and the focused item, taking into account the user preferences.
+/// Gets the interpreted version of each of the specified texts containing Title Formating instructions. The track is resolved only once for all texts.
 /// </summary>
-HRESULT HostObject::GetTrackIndex(t_size & playlistIndex, t_size & itemIndex) noexcept
+STDMETHODIMP HostObject::GetFormattedTexts(VARIANT texts, VARIANT * formattedTexts)
 {
-    auto SelectionManager = ui_selection_manager::get();
+    trace_scope_t Scope("HostObject.GetFormattedTexts", _TraceLane);
+    host_call_timer_t Timer(_Statistics, host_method_t::GetFormattedTexts);
+
+    if (formattedTexts == nullptr)
+        return E_POINTER;
+
+    std::vector<std::wstring> Texts;
 
-    auto SelectionType = SelectionManager->get_selection_type();
+    HRESULT hr = GetStrings(texts, Texts);
 
-    // Description as used in the Preferences dialog (Display / Selection Viewers).
-    const bool PreferCurrentlyPlayingTrack = (SelectionType == contextmenu_item::caller_now_playing);
-    const bool PreferCurrentSelection      = (SelectionType == contextmenu_item::caller_active_playlist_selection);
+    if (!SUCCEEDED(hr))
+        return hr;
 
-    bool IsTrackPlaying = false;
+    formatter_t Formatter;
 
-    static_api_ptr_t<playlist_manager> PlaylistManager;
+    SAFEARRAY * Array = ::SafeArrayCreateVector(VT_VARIANT, 0, (ULONG) Texts.size());
 
-    if (PreferCurrentlyPlayingTrack)
-        IsTrackPlaying = PlaylistManager->get_playing_item_location(&playlistIndex, &itemIndex);
+    if (Array == nullptr)
+        return E_OUTOFMEMORY;
 
-    if (PreferCurrentSelection || !IsTrackPlaying)
+    VARIANT * Items = nullptr;
+
+    hr = ::SafeArrayAccessData(Array, (void **) &Items);
+
+    if (!SUCCEEDED(hr))
     {
-        playlistIndex = PlaylistManager->get_active_playlist();
+        ::SafeArrayDestroy(Array);
 
-        if (playlistIndex == ~0u)
-            return E_FAIL;
+        return hr;
+    }
+
+    for (size_t i = 0; i < Texts.size(); ++i)
+    {
+        std::wstring FormattedText;
 
-        itemIndex = PlaylistManager->playlist_get_focus_item(playlistIndex);
+        (void) Formatter.Format(Texts[i].c_str(), Texts[i].length(), FormattedText); // A text that fails to compile or isn't valid UTF-16 results in an empty string.
 
-        if (itemIndex == ~0u)
-            return E_FAIL;
+        Items[i].vt = VT_BSTR;
+        Items[i].bstrVal = ::SysAllocStringLen(FormattedText.c_str(), (UINT) FormattedText.length());
     }
 
+    ::SafeArrayUnaccessData(Array);
+
+    ::VariantInit(formattedTexts);
+
+    formattedTexts->vt = VT_ARRAY | VT_VARIANT;
+    formattedTexts->parray = Array;
+
     return S_OK;
 }
 
-#pragma region IDispatch
-
 /// <summary>
-/// Retrieves the number of type information interfaces that an object provides (either 0 or 1).
+/// Registers the texts that the host formats and pushes to the page whenever the track or its information changes.
 /// </summary>
-STDMETHODIMP HostObject::GetTypeInfoCount(UINT * typeInfoCount)
+STDMETHODIMP HostObject::RegisterFields(VARIANT texts)
 {
-    *typeInfoCount = 1;
+    trace_scope_t Scope("HostObject.RegisterFields", _TraceLane);
+    host_call_timer_t Timer(_Statistics, host_method_t::RegisterFields);
+
+    std::vector<std::wstring> Texts;
+
+    HRESULT hr = GetStrings(texts, Texts);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    if (_RegisterFields)
+        _RegisterFields(Texts);
 
     return S_OK;
 }
 
 /// <summary>
-/// Retrieves the type information for an object, which can then be used to get the type information for an interface.
+/// Gets the statistics of the panel as a JSON string: the event counters, the event latencies, the duration of the host object calls and the number of scripts executed.
+/// </summary>
+STDMETHODIMP HostObject::GetStatistics(BSTR * statistics)
+{
+    host_call_timer_t Timer(_Statistics, host_method_t::GetStatistics);
+
+    if (statistics == nullptr)
+        return E_POINTER;
+
+    const std::string JSON = _GetStatistics ? _GetStatistics() : "{}";
+
+    const std::wstring Statistics = ::UTF8ToWide(JSON);
+
+    *statistics = ::SysAllocStringLen(Statistics.c_str(), (UINT) Statistics.length());
+
+    return (*statistics != nullptr) ? S_OK : E_OUTOFMEMORY;
+}
+
+/// <summary>
+/// Gets the strings contained in a script array. Arrays can arrive as a SAFEARRAY or as a proxy of the script object.
 /// </summary>
-STDMETHODIMP HostObject::GetTypeInfo(UINT typeInfoIndex, LCID lcid, ITypeInfo ** typeInfo)
+HRESULT HostObject::GetStrings(const VARIANT & value, std::vector<std::wstring> & strings) noexcept
 {
-    if (typeInfoIndex != 0)
-        return TYPE_E_ELEMENTNOTFOUND;
+    strings.clear();
 
-    if (_TypeLibrary == nullptr)
+    if ((value.vt == (VT_ARRAY | VT_VARIANT)) || (value.vt == (VT_ARRAY | VT_BSTR)))
     {
-        // FIXME: The type library should be embedded in the resources of the component DLL, not a separate file.
-        std::wstring TypeLibFilePath;
+        SAFEARRAY * Array = value.parray;
 
-        HRESULT hr = GetTypeLibFilePath(TypeLibFilePath);
+        if ((Array == nullptr) || (::SafeArrayGetDim(Array) != 1))
+            return E_INVALIDARG;
 
-        if (!SUCCEEDED(hr))
-            return hr;
+        LONG LBound = 0, UBound = -1;
 
-        hr = ::LoadTypeLib(TypeLibFilePath.c_str(), &_TypeLibrary);
+        ::SafeArrayGetLBound(Array, 1, &LBound);
+        ::SafeArrayGetUBound(Array, 1, &UBound);
+
+        for (LONG i = LBound; i <= UBound; ++i)
+        {
+            VARIANT Item = {};
+
+            HRESULT hr;
+
+            if (value.vt == (VT_ARRAY | VT_BSTR))
+            {
+                Item.vt = VT_BSTR;
+
+                hr = ::SafeArrayGetElement(Array, &i, &Item.bstrVal);
+            }
+            else
+                hr = ::SafeArrayGetElement(Array, &i, &Item);
+
+            if (SUCCEEDED(hr))
+                hr = ::VariantChangeType(&Item, &Item, 0, VT_BSTR);
+
+            strings.push_back(SUCCEEDED(hr) && (Item.bstrVal != nullptr) ? Item.bstrVal : L"");
+
+            ::VariantClear(&Item);
+        }
+
+        return S_OK;
+    }
+
+    if ((value.vt == VT_DISPATCH) && (value.pdispVal != nullptr))
+    {
+        VARIANT Length = {};
+
+        HRESULT hr = GetProperty(value.pdispVal, L"length", Length);
+
+        if (SUCCEEDED(hr))
+            hr = ::VariantChangeType(&Length, &Length, 0, VT_UI4);
 
         if (!SUCCEEDED(hr))
             return hr;
+
+        for (ULONG i = 0; i < Length.ulVal; ++i)
+        {
+            VARIANT Item = {};
+
+            hr = GetProperty(value.pdispVal, std::to_wstring(i).c_str(), Item);
+
+            if (SUCCEEDED(hr))
+                hr = ::VariantChangeType(&Item, &Item, 0, VT_BSTR);
+
+            strings.push_back(SUCCEEDED(hr) && (Item.bstrVal != nullptr) ? Item.bstrVal : L"");
+
+            ::VariantClear(&Item);
+        }
+
+        return S_OK;
     }
 
-    return _TypeLibrary->GetTypeInfoOfGuid(__uuidof(IHostObject), typeInfo);
+    return E_INVALIDARG;
 }
 
 /// <summary>
-/// Maps a single member and an optional set of argument names to a corresponding set of integer DISPIDs, which can be used on subsequent calls to Invoke.
+/// Gets the value of the specified property of a script object.
 /// </summary>
-STDMETHODIMP HostObject::GetIDsOfNames(REFIID riid, LPOLESTR * names, UINT nameCount, LCID lcid, DISPID * dispIds)
+HRESULT HostObject::GetProperty(IDispatch * object, const wchar_t * name, VARIANT & value) noexcept
 {
-    wil::com_ptr<ITypeInfo> TypeInfo;
+    DISPID DispId;
+
+    LPOLESTR Name = (LPOLESTR) name;
 
-    HRESULT hr = GetTypeInfo(0, lcid, &TypeInfo);
+    HRESULT hr = object->GetIDsOfNames(IID_NULL, &Name, 1, LOCALE_USER_DEFAULT, &DispId);
 
     if (!SUCCEEDED(hr))
         return hr;
 
-    return TypeInfo->GetIDsOfNames(names, nameCount, dispIds);
+    DISPPARAMS NoArguments = {};
+
+    return object->Invoke(DispId, IID_NULL, LOCALE_USER_DEFAULT, DISPATCH_PROPERTYGET, &NoArguments, &value, nullptr, nullptr);
+}
+
+#pragma region IDispatch
+
+namespace
+{
+    /// <summary>
+    /// Compares two member names without regard to case, like the script engine does.
+    /// </summary>
+    constexpr int CompareNames(const wchar_t * a, const wchar_t * b) noexcept
+    {
+        auto ToLower = [](wchar_t c) constexpr { return ((c >= L'A') && (c <= L'Z')) ? (wchar_t) (c + (L'a' - L'A')) : c; };
+
+        while ((*a != L'\0') && (ToLower(*a) == ToLower(*b)))
+        {
+            ++a;
+            ++b;
+        }
+
+        return (int) ToLower(*a) - (int) ToLower(*b);
+    }
+
+    struct member_t
+    {
+        const wchar_t * Name;
+        DISPID DispId;
+        UINT ArgumentCount;
+    };
+
+    /// <summary>
+    /// The methods exposed to the template, sorted by name.
+    /// </summary>
+    constexpr member_t Members[] =
+    {
+        { L"GetFormattedText",  HostObject::DispIdGetFormattedText,  1 },
+        { L"GetFormattedTexts", HostObject::DispIdGetFormattedTexts, 1 },
+        { L"GetStatistics",     HostObject::DispIdGetStatistics,     0 },
+        { L"RegisterFields",    HostObject::DispIdRegisterFields,    1 },
+    };
+
+    constexpr bool IsSorted() noexcept
+    {
+        for (size_t i = 1; i < _countof(Members); ++i)
+            if (CompareNames(Members[i - 1].Name, Members[i].Name) >= 0)
+                return false;
+
+        return true;
+    }
+
+    static_assert(IsSorted(), "The members must be sorted by name for the binary search in GetDispId().");
 }
 
 /// <summary>
-/// Provides access to the properties and methods exposed by this object.
+/// Retrieves the number of type information interfaces that an object provides (either 0 or 1). The methods are dispatched without a type library.
 /// </summary>
-STDMETHODIMP HostObject::Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD flags, DISPPARAMS * dispParams, VARIANT * result, EXCEPINFO * excepInfo, UINT * argErr)
+STDMETHODIMP HostObject::GetTypeInfoCount(UINT * typeInfoCount)
 {
-    wil::com_ptr<ITypeInfo> TypeInfo;
+    if (typeInfoCount == nullptr)
+        return E_POINTER;
 
-    HRESULT hr = GetTypeInfo(0, lcid, &TypeInfo);
+    *typeInfoCount = 0;
 
-    if (!SUCCEEDED(hr))
-        return hr;
+    return S_OK;
+}
 
-    return TypeInfo->Invoke(this, dispIdMember, flags, dispParams, result, excepInfo, argErr);
+/// <summary>
+/// Retrieves the type information for an object, which can then be used to get the type information for an interface.
+/// </summary>
+STDMETHODIMP HostObject::GetTypeInfo(UINT, LCID, ITypeInfo ** typeInfo)
+{
+    if (typeInfo == nullptr)
+        return E_POINTER;
+
+    *typeInfo = nullptr;
+
+    return E_NOTIMPL;
+}
+
+/// <summary>
+/// Maps a single member and an optional set of argument names to a corresponding set of integer DISPIDs, which can be used on subsequent calls to Invoke.
+/// </summary>
+STDMETHODIMP HostObject::GetIDsOfNames(REFIID riid, LPOLESTR * names, UINT nameCount, LCID, DISPID * dispIds)
+{
+    if (riid != IID_NULL)
+        return DISP_E_UNKNOWNINTERFACE;
+
+    if ((names == nullptr) || (dispIds == nullptr) || (nameCount == 0))
+        return E_INVALIDARG;
+
+    dispIds[0] = GetDispId(names[0]);
+
+    // None of the methods support named arguments.
+    for (UINT i = 1; i < nameCount; ++i)
+        dispIds[i] = DISPID_UNKNOWN;
+
+    return ((dispIds[0] != DISPID_UNKNOWN) && (nameCount == 1)) ? S_OK : DISP_E_UNKNOWNNAME;
 }
 
 /// <summary>
-/// Gets the complete file path of our type library.
+/// Provides access to the properties and methods exposed by this object.
 /// </summary>
-HRESULT HostObject::GetTypeLibFilePath(std::wstring & filePath) noexcept
+STDMETHODIMP HostObject::Invoke(DISPID dispIdMember, REFIID riid, LCID, WORD flags, DISPPARAMS * dispParams, VARIANT * result, EXCEPINFO *, UINT * argErr)
 {
-    wchar_t FilePath[MAX_PATH];
+    if (riid != IID_NULL)
+        return DISP_E_UNKNOWNINTERFACE;
+
+    if ((flags & DISPATCH_METHOD) == 0)
+        return DISP_E_MEMBERNOTFOUND;
 
-    HMODULE hModule = GetCurrentModule();
+    const auto Member = std::find_if(std::begin(Members), std::end(Members), [dispIdMember](const member_t & m) { return m.DispId == dispIdMember; });
 
-    if (hModule == NULL)
-        return HRESULT_FROM_WIN32(::GetLastError());
+    if (Member == std::end(Members))
+        return DISP_E_MEMBERNOTFOUND;
 
-    if (::GetModuleFileNameW(hModule, FilePath, _countof(FilePath)) == 0)
-        return HRESULT_FROM_WIN32(::GetLastError());
+    const VARIANT * Arguments[1] = { };
 
-    HRESULT hr = ::PathCchRemoveFileSpec(FilePath, _countof(FilePath));
+    HRESULT hr = GetArguments(dispParams, Member->ArgumentCount, Arguments);
 
     if (!SUCCEEDED(hr))
         return hr;
 
-    ::PathCchAppend(FilePath, _countof(FilePath), TEXT(STR_COMPONENT_BASENAME) L".tlb");
+    VARIANT Result;
+
+    ::VariantInit(&Result);
+
+    switch (dispIdMember)
+    {
+        case DispIdGetFormattedText:
+        {
+            VARIANT Text;
+
+            ::VariantInit(&Text);
+
+            hr = ::VariantChangeType(&Text, Arguments[0], 0, VT_BSTR);
+
+            if (!SUCCEEDED(hr))
+            {
+                if (argErr != nullptr)
+                    *argErr = 0;
+
+                return DISP_E_TYPEMISMATCH;
+            }
+
+            hr = GetFormattedText(Text.bstrVal, &Result.bstrVal);
+
+            if (SUCCEEDED(hr))
+                Result.vt = VT_BSTR;
+
+            ::VariantClear(&Text);
+            break;
+        }
+
+        case DispIdGetFormattedTexts:
+        {
+            hr = GetFormattedTexts(*Arguments[0], &Result);
+            break;
+        }
+
+        case DispIdRegisterFields:
+        {
+            hr = RegisterFields(*Arguments[0]);
+            break;
+        }
+
+        case DispIdGetStatistics:
+        {
+            hr = GetStatistics(&Result.bstrVal);
+
+            if (SUCCEEDED(hr))
+                Result.vt = VT_BSTR;
+            break;
+        }
+    }
 
     if (!SUCCEEDED(hr))
         return hr;
 
-    filePath = FilePath;
+    if (result != nullptr)
+        *result = Result;
+    else
+        ::VariantClear(&Result);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the DISPID of the method with the specified name.
+/// </summary>
+DISPID HostObject::GetDispId(const wchar_t * name) noexcept
+{
+    if (name == nullptr)
+        return DISPID_UNKNOWN;
+
+    const auto Member = std::lower_bound(std::begin(Members), std::end(Members), name, [](const member_t & m, const wchar_t * name) { return CompareNames(m.Name, name) < 0; });
+
+    return ((Member != std::end(Members)) && (CompareNames(Member->Name, name) == 0)) ? Member->DispId : DISPID_UNKNOWN;
+}
+
+/// <summary>
+/// Gets the positional arguments of a call in the order of the method declaration. Script engines pass them in reverse order and sometimes by reference.
+/// </summary>
+HRESULT HostObject::GetArguments(const DISPPARAMS * dispParams, UINT count, const VARIANT ** arguments) noexcept
+{
+    const UINT ArgumentCount = (dispParams != nullptr) ? dispParams->cArgs : 0;
+
+    if ((dispParams != nullptr) && (dispParams->cNamedArgs != 0))
+        return DISP_E_NONAMEDARGS;
+
+    if (ArgumentCount != count)
+        return DISP_E_BADPARAMCOUNT;
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        const VARIANT * Argument = &dispParams->rgvarg[count - 1 - i];
+
+        if ((Argument->vt == (VT_BYREF | VT_VARIANT)) && (Argument->pvarVal != nullptr))
+            Argument = Argument->pvarVal;
+
+        arguments[i] = Argument;
+    }
 
     return S_OK;
 }
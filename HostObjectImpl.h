@@ -1,5 +1,5 @@
 
-/** $VER: HostObjectImpl.h (2024.06.05) P. Stuer **/
+/** $VER: HostObjectImpl.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
@@ -8,6 +8,7 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <wrl.h>
 #include <wrl/client.h>
@@ -20,6 +21,8 @@
 
 #include "HostObject_h.h"
 
+#include "Statistics.h"
+
 class HostObject : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, IHostObject, IDispatch>
 {
 public:
@@ -32,12 +35,17 @@ public:
 
     typedef std::function<void(void)> Callback;
     typedef std::function<void(Callback)> RunCallbackAsync;
+    typedef std::function<void(const std::vector<std::wstring> &)> RegisterFieldsCallback;
+    typedef std::function<std::string(void)> GetStatisticsCallback;
 
-    HostObject(RunCallbackAsync runCallbackAsync);
+    HostObject(RunCallbackAsync runCallbackAsync, RegisterFieldsCallback registerFields, GetStatisticsCallback getStatistics, statistics_t & statistics, uint32_t traceLane);
 
     #pragma region IHostObject
 
     STDMETHODIMP GetFormattedText(BSTR text, BSTR * formattedText) override;
+    STDMETHODIMP GetFormattedTexts(VARIANT texts, VARIANT * formattedTexts) override;
+    STDMETHODIMP RegisterFields(VARIANT texts) override;
+    STDMETHODIMP GetStatistics(BSTR * statistics) override;
 
     #pragma endregion
 
@@ -50,13 +58,30 @@ public:
 
     #pragma endregion
 
-private:
-    static HRESULT GetTrackIndex(t_size & playlistIndex, t_size & itemIndex) noexcept;
-    static HRESULT GetTypeLibFilePath(std::wstring & filePath) noexcept;
+    /// <summary>
+    /// The DISPIDs of the methods exposed to the template.
+    /// </summary>
+    enum : DISPID
+    {
+        DispIdGetFormattedText = 1,
+        DispIdGetFormattedTexts,
+        DispIdRegisterFields,
+        DispIdGetStatistics,
+    };
 
 private:
-    wil::com_ptr<ITypeLib> _TypeLibrary;
+    static HRESULT GetStrings(const VARIANT & value, std::vector<std::wstring> & strings) noexcept;
+    static HRESULT GetProperty(IDispatch * object, const wchar_t * name, VARIANT & value) noexcept;
+
+    static DISPID GetDispId(const wchar_t * name) noexcept;
+    static HRESULT GetArguments(const DISPPARAMS * dispParams, UINT count, const VARIANT ** arguments) noexcept;
 
+private:
     wil::com_ptr<IDispatch> _Callback;
     RunCallbackAsync _RunCallbackAsync;
+    RegisterFieldsCallback _RegisterFields;
+    GetStatisticsCallback _GetStatistics;
+
+    statistics_t & _Statistics;
+    uint32_t _TraceLane;
 };
@@ -0,0 +1,208 @@
+
+/** $VER: JapaneseDecoder.cpp (2026.10.17) P. Stuer - Decodes Shift-JIS (code page 932) and EUC-JP without the code page tables of the operating system. **/
+
+#include "JapaneseDecoder.h"
+#include "CP932Table.h"
+
+#include <array>
+
+namespace
+{
+    constexpr uint8_t NoRow = 0xFF;
+
+    constexpr uint32_t FirstUserDefinedRow = 95;  // Lead byte 0xF0
+    constexpr uint32_t LastUserDefinedRow = 114;  // Lead byte 0xF9
+
+    /// <summary>
+    /// Builds the table that maps a Shift-JIS trail byte to its cell (bits 0-6) and to the row of the pair it belongs to (bit 7 set for the even row). 0 = not a trail byte.
+    /// </summary>
+    constexpr std::array<uint8_t, 256> GetTrailTable() noexcept
+    {
+        std::array<uint8_t, 256> Table = { };
+
+        for (uint32_t i = 0x40; i <= 0x7E; ++i)
+            Table[i] = (uint8_t) (i - 0x3F);            // Odd row, cells 1 to 63
+
+        for (uint32_t i = 0x80; i <= 0x9E; ++i)
+            Table[i] = (uint8_t) (i - 0x40);            // Odd row, cells 64 to 94
+
+        for (uint32_t i = 0x9F; i <= 0xFC; ++i)
+            Table[i] = (uint8_t) (0x80 | (i - 0x9E));   // Even row, cells 1 to 94
+
+        return Table;
+    }
+
+    /// <summary>
+    /// Builds the table that maps a Shift-JIS lead byte to the odd row of the pair of rows it encodes. 0 = not a lead byte.
+    /// </summary>
+    constexpr std::array<uint8_t, 256> GetLeadTable() noexcept
+    {
+        std::array<uint8_t, 256> Table = { };
+
+        for (uint32_t i = 0x81; i <= 0x9F; ++i)
+            Table[i] = (uint8_t) (((i - 0x81) * 2) + 1);    // Rows 1 to 62
+
+        for (uint32_t i = 0xE0; i <= 0xFC; ++i)
+            Table[i] = (uint8_t) (((i - 0xE0) * 2) + 63);   // Rows 63 to 120
+
+        return Table;
+    }
+
+    constexpr std::array<uint8_t, 256> TrailTable = GetTrailTable();
+    constexpr std::array<uint8_t, 256> LeadTable = GetLeadTable();
+
+    static_assert(sizeof(CP932RowIndex) == 121, "The row index must cover rows 0 to 120.");
+
+    /// <summary>
+    /// Looks up the character at the specified row (1 to 120) and cell (1 to 94) of code page 932. Returns 0 if there is none.
+    /// </summary>
+    inline char16_t GetCP932Character(uint32_t row, uint32_t cell) noexcept
+    {
+        if ((row >= FirstUserDefinedRow) && (row <= LastUserDefinedRow))
+            return (char16_t) (0xE000 + ((row - FirstUserDefinedRow) * 94) + (cell - 1));
+
+        const uint8_t Index = CP932RowIndex[row];
+
+        return (Index != NoRow) ? CP932Rows[Index][cell - 1] : 0;
+    }
+
+    /// <summary>
+    /// Looks up the character at the specified row (1 to 94) and cell (1 to 94) of JIS X 0208. Returns 0 if there is none.
+    /// </summary>
+    inline char16_t GetJISX0208Character(uint32_t row, uint32_t cell) noexcept
+    {
+        // Row 13 and rows 89 to 92 hold the NEC and IBM extensions of code page 932.
+        if ((row == 13) || ((row >= 89) && (row <= 92)))
+            return 0;
+
+        if (row <= 2)
+        {
+            for (const auto & Override : JISX0208Overrides)
+            {
+                if ((Override.Row == row) && (Override.Cell == cell))
+                    return Override.CodePoint;
+            }
+        }
+
+        const uint8_t Index = CP932RowIndex[row];
+
+        return (Index != NoRow) ? CP932Rows[Index][cell - 1] : 0;
+    }
+}
+
+/// <summary>
+/// Converts Shift-JIS, as defined by code page 932 (CP932.TXT), to UTF-16. The destination must hold at least GetJapaneseUTF16Capacity(size) code units.
+/// Stops at the first byte sequence without a mapping, including the single bytes 0x80, 0xA0 and 0xFD to 0xFF that Windows maps to private code points.
+/// </summary>
+transcode_result_t ShiftJISToUTF16(const char * src, size_t size, char16_t * dst) noexcept
+{
+    const uint8_t * Src = (const uint8_t *) src;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < size)
+    {
+        const uint8_t c = Src[i];
+
+        if (c < 0x80)
+        {
+            const size_t n = WidenASCII(src + i, size - i, dst + j);
+
+            i += n;
+            j += n;
+
+            continue;
+        }
+
+        if ((c >= 0xA1) && (c <= 0xDF))
+        {
+            dst[j++] = (char16_t) (0xFF61 + (c - 0xA1)); // Half-width katakana
+            ++i;
+
+            continue;
+        }
+
+        const uint32_t Row = LeadTable[c];
+
+        if (Row == 0)
+            return { i, j, transcode_error_t::InvalidSequence };
+
+        if (i + 1 == size)
+            return { i, j, transcode_error_t::Truncated };
+
+        const uint32_t Trail = TrailTable[Src[i + 1]];
+
+        if (Trail == 0)
+            return { i, j, transcode_error_t::InvalidSequence };
+
+        const char16_t Character = GetCP932Character(Row + (Trail >> 7), Trail & 0x7F);
+
+        if (Character == 0)
+            return { i, j, transcode_error_t::InvalidSequence };
+
+        dst[j++] = Character;
+        i += 2;
+    }
+
+    return { i, j, transcode_error_t::None };
+}
+
+/// <summary>
+/// Converts EUC-JP to UTF-16. The destination must hold at least GetJapaneseUTF16Capacity(size) code units.
+/// Supports ASCII, JIS X 0208 (JIS0208.TXT) and half-width katakana. Stops at the first JIS X 0212 character (SS3) or byte sequence without a mapping.
+/// </summary>
+transcode_result_t EUCJPToUTF16(const char * src, size_t size, char16_t * dst) noexcept
+{
+    const uint8_t * Src = (const uint8_t *) src;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < size)
+    {
+        const uint8_t c = Src[i];
+
+        if (c < 0x80)
+        {
+            const size_t n = WidenASCII(src + i, size - i, dst + j);
+
+            i += n;
+            j += n;
+
+            continue;
+        }
+
+        if ((c != 0x8E) && ((c < 0xA1) || (c > 0xFE)))
+            return { i, j, transcode_error_t::InvalidSequence };
+
+        if (i + 1 == size)
+            return { i, j, transcode_error_t::Truncated };
+
+        const uint8_t d = Src[i + 1];
+
+        if (c == 0x8E)
+        {
+            if ((d < 0xA1) || (d > 0xDF))
+                return { i, j, transcode_error_t::InvalidSequence };
+
+            dst[j++] = (char16_t) (0xFF61 + (d - 0xA1)); // Half-width katakana
+        }
+        else
+        {
+            if ((d < 0xA1) || (d > 0xFE))
+                return { i, j, transcode_error_t::InvalidSequence };
+
+            const char16_t Character = GetJISX0208Character(c - 0xA0u, d - 0xA0u);
+
+            if (Character == 0)
+                return { i, j, transcode_error_t::InvalidSequence };
+
+            dst[j++] = Character;
+        }
+
+        i += 2;
+    }
+
+    return { i, j, transcode_error_t::None };
+}
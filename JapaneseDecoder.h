@@ -0,0 +1,17 @@
+
+/** $VER: JapaneseDecoder.h (2026.10.17) P. Stuer - Decodes Shift-JIS (code page 932) and EUC-JP without the code page tables of the operating system. **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Transcoder.h"
+
+/// <summary>
+/// Gets the number of UTF-16 code units that is always large enough to hold the conversion of the specified number of Shift-JIS or EUC-JP bytes.
+/// </summary>
+constexpr size_t GetJapaneseUTF16Capacity(size_t size) noexcept { return size; }
+
+transcode_result_t ShiftJISToUTF16(const char * src, size_t size, char16_t * dst) noexcept;
+transcode_result_t EUCJPToUTF16(const char * src, size_t size, char16_t * dst) noexcept;
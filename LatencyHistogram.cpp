@@ -0,0 +1,79 @@
+
+/** $VER: LatencyHistogram.cpp (2026.10.17) P. Stuer - Implements a log-linear latency histogram. **/
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// <summary>
+/// Adds a value to the histogram.
+/// </summary>
+void latency_histogram_t::Record(uint64_t value) noexcept
+{
+    if (value > MaxValue)
+        value = MaxValue;
+
+    ++_Counts[GetIndex(value)];
+
+    _Min = (_Count == 0) ? value : (std::min)(_Min, value);
+    _Max = (std::max)(_Max, value);
+
+    ++_Count;
+    _Sum += value;
+}
+
+/// <summary>
+/// Gets the value below which the specified percentage (0 - 100) of the values fall. The result is the upper bound of the bucket that contains it.
+/// </summary>
+uint64_t latency_histogram_t::GetPercentile(double percentile) const noexcept
+{
+    if (_Count == 0)
+        return 0;
+
+    const uint64_t Rank = (std::max)((uint64_t) std::ceil(percentile / 100. * (double) _Count), (uint64_t) 1);
+
+    uint64_t Total = 0;
+
+    for (size_t i = 0; i < BucketCount; ++i)
+    {
+        Total += _Counts[i];
+
+        if (Total >= Rank)
+            return (std::min)(GetUpperBound(i), _Max);
+    }
+
+    return _Max;
+}
+
+/// <summary>
+/// Gets the bucket of a value. Values below 16 have a bucket of their own; larger values are divided in 16 buckets per power of 2.
+/// </summary>
+size_t latency_histogram_t::GetIndex(uint64_t value) noexcept
+{
+    if (value < SubBucketCount)
+        return (size_t) value;
+
+    size_t Exponent = 0; // Position of the most significant bit.
+
+    for (uint64_t v = value; v > 1; v >>= 1)
+        ++Exponent;
+
+    const size_t Shift = Exponent - SubBucketBits;
+
+    return (Exponent - SubBucketBits + 1) * SubBucketCount + (size_t) ((value >> Shift) - SubBucketCount);
+}
+
+/// <summary>
+/// Gets the largest value that belongs to a bucket.
+/// </summary>
+uint64_t latency_histogram_t::GetUpperBound(size_t index) noexcept
+{
+    if (index < SubBucketCount)
+        return index;
+
+    const size_t Shift = (index / SubBucketCount) - 1;
+    const uint64_t Mantissa = (index % SubBucketCount) + SubBucketCount;
+
+    return ((Mantissa + 1) << Shift) - 1;
+}
@@ -0,0 +1,44 @@
+
+/** $VER: LatencyHistogram.h (2026.10.17) P. Stuer - Implements a log-linear latency histogram. **/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Implements a log-linear latency histogram (HDR-style): 16 linear sub-buckets per power of 2, i.e. a relative error of at most 6.25%. Values are in microseconds.
+/// Depends only on the standard library so that it can be tested on any platform.
+/// </summary>
+class latency_histogram_t
+{
+public:
+    latency_histogram_t() noexcept : _Counts(), _Count(), _Sum(), _Min(), _Max() { }
+
+    void Record(uint64_t value) noexcept;
+
+    uint64_t GetCount() const noexcept { return _Count; }
+    uint64_t GetMin() const noexcept { return _Min; }
+    uint64_t GetMax() const noexcept { return _Max; }
+    double GetMean() const noexcept { return (_Count != 0) ? (double) _Sum / (double) _Count : 0.; }
+
+    uint64_t GetPercentile(double percentile) const noexcept;
+
+    static size_t GetIndex(uint64_t value) noexcept;
+    static uint64_t GetUpperBound(size_t index) noexcept;
+
+public:
+    static const size_t SubBucketBits = 4;
+    static const size_t SubBucketCount = 1 << SubBucketBits;
+    static const uint64_t MaxValue = 0xFFFFFFFFull; // Larger values (more than 71 minutes) are clamped.
+    static const size_t BucketCount = (32 - SubBucketBits + 1) * SubBucketCount;
+
+private:
+    std::array<uint32_t, BucketCount> _Counts;
+
+    uint64_t _Count;
+    uint64_t _Sum;
+    uint64_t _Min;
+    uint64_t _Max;
+};
@@ -0,0 +1,100 @@
+<#
+.SYNOPSIS
+    Measures the startup time of layouts with a different number of panels.
+.DESCRIPTION
+    Starts and stops each portable foobar2000 installation a number of times and reads the trace written by the component when foobar2000 shuts down.
+    Each installation must have a layout with the number of panels to measure (e.g. 1, 4 and 8) and "Enable tracing" checked in Advanced Preferences.
+    The first start of each installation is discarded: the environment is only prewarmed if the previous session had at least one panel.
+    Reports the median over the remaining runs of the time after startup at which the last panel created its WebView and loaded its template.
+.EXAMPLE
+    C:\PS> .\Measure-Startup.ps1 -Installations ..\bin\1-panel, ..\bin\4-panels, ..\bin\8-panels -Runs 5
+.OUTPUTS
+    A table with one row per installation.
+#>
+
+[CmdletBinding()]
+param
+(
+    [parameter(Mandatory, HelpMessage='Portable foobar2000 installations')]
+        [string[]] $Installations,
+    [parameter(HelpMessage='Number of measured runs per installation')]
+        [int] $Runs = 5,
+    [parameter(HelpMessage='Seconds to wait for the panels to load')]
+        [int] $Wait = 10
+)
+
+#Requires -Version 7.2
+
+Set-StrictMode -Version Latest;
+Set-PSDebug -Strict; # Equivalent of VBA "Option Explicit".
+
+$ErrorActionPreference = 'Stop';
+
+function Get-Median([double[]] $Values)
+{
+    $Sorted = $Values | Sort-Object;
+
+    return $Sorted[[math]::Floor(($Sorted.Count - 1) / 2)];
+}
+
+$Results = foreach ($Installation in $Installations)
+{
+    $ExecutablePath = Join-Path $Installation 'foobar2000.exe';
+    $TracePath = Join-Path $Installation 'profile/foo_vis_text/trace.json';
+
+    if (!(Test-Path -Path $ExecutablePath))
+    {
+        Write-Host "Skipped `"$Installation`": foobar2000.exe not found.";
+        continue;
+    }
+
+    $Controllers = @();
+    $Navigations = @();
+    $Panels = 0;
+
+    for ($Run = 0; $Run -le $Runs; $Run++)
+    {
+        Write-Host "Starting `"$Installation`" ($Run/$Runs)...";
+
+        Remove-Item -Path $TracePath -Force -ErrorAction SilentlyContinue;
+
+        $Process = Start-Process -FilePath $ExecutablePath -PassThru;
+
+        Start-Sleep -Seconds $Wait;
+
+        # Let foobar2000 shut down normally so that the component writes the trace.
+        Start-Process -FilePath $ExecutablePath -ArgumentList '/exit' -Wait;
+
+        $Process.WaitForExit();
+
+        if ($Run -eq 0)
+        {
+            continue; # The environment was not prewarmed if the previous session had no panels.
+        }
+
+        if (!(Test-Path -Path $TracePath))
+        {
+            throw "No trace written to `"$TracePath`". Check `"Enable tracing`" in Advanced Preferences.";
+        }
+
+        # The time stamps are in microseconds since the component was initialized.
+        $Events = (Get-Content -Path $TracePath -Raw | ConvertFrom-Json).traceEvents | Where-Object { $_.ph -eq 'X' };
+
+        $ControllerEvents = @($Events | Where-Object { $_.name -eq 'ControllerCompleted' });
+        $NavigationEvents = @($Events | Where-Object { $_.name -eq 'NavigationCompleted' });
+
+        $Panels = ($ControllerEvents | Select-Object -ExpandProperty tid -Unique | Measure-Object).Count;
+
+        $Controllers += ($ControllerEvents | ForEach-Object { $_.ts + $_.dur } | Measure-Object -Maximum).Maximum / 1000.;
+        $Navigations += ($NavigationEvents | ForEach-Object { $_.ts + $_.dur } | Measure-Object -Maximum).Maximum / 1000.;
+    }
+
+    [pscustomobject] @{
+        Installation          = $Installation;
+        Panels                = $Panels;
+        'Last WebView (ms)'   = [math]::Round((Get-Median $Controllers), 1);
+        'Last template (ms)'  = [math]::Round((Get-Median $Navigations), 1);
+    }
+}
+
+$Results | Format-Table -AutoSize;
@@ -0,0 +1,173 @@
+
+/** $VER: Mojibake.cpp (2026.10.17) P. Stuer - Repairs texts that were decoded with the wrong code page. **/
+
+#include "Mojibake.h"
+#include "EncodingDetector.h"
+#include "JapaneseDecoder.h"
+#include "Transcoder.h"
+#include "Validators.h"
+
+#include <iterator>
+
+namespace
+{
+    /// <summary>
+    /// The characters of Windows-1252 for the bytes 0x80 to 0x9F. The undefined bytes map to the C1 control with the same value, like MultiByteToWideChar() does.
+    /// </summary>
+    const char16_t Windows1252[32] =
+    {
+        0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+        0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+        0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+        0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+    };
+
+    /// <summary>
+    /// Gets the Latin-1 or Windows-1252 byte of the specified character. Returns false if neither code page contains it.
+    /// </summary>
+    bool GetByte(uint32_t c, uint8_t & byte) noexcept
+    {
+        if (c <= 0xFF)
+        {
+            byte = (uint8_t) c;
+
+            return true;
+        }
+
+        for (size_t i = 0; i < std::size(Windows1252); ++i)
+        {
+            if (Windows1252[i] == c)
+            {
+                byte = (uint8_t) (0x80 + i);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+/// <summary>
+/// Repairs the specified UTF-8 text. Returns false, and leaves the result untouched, if the text doesn't look like a mis-decoded Japanese text.
+/// Bytes that form valid UTF-8 are left alone: real Latin text such as "Ã©" or "Â£" has the same byte image as a mis-decoded UTF-8 text.
+/// </summary>
+bool mojibake_repairer_t::Repair(const char * text, size_t size, std::string & repairedText) noexcept
+{
+    if (!GetBytes(text, size))
+        return false;
+
+    transcode_result_t Result;
+
+    switch (DetectEncoding(_Bytes.data(), _Bytes.size()))
+    {
+        case encoding_t::ShiftJIS:
+        {
+            _Wide.resize(GetJapaneseUTF16Capacity(_Bytes.size()));
+
+            Result = ::ShiftJISToUTF16(_Bytes.data(), _Bytes.size(), _Wide.data());
+            break;
+        }
+
+        case encoding_t::EUCJP:
+        {
+            _Wide.resize(GetJapaneseUTF16Capacity(_Bytes.size()));
+
+            Result = ::EUCJPToUTF16(_Bytes.data(), _Bytes.size(), _Wide.data());
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    if (!Result.IsValid())
+        return false;
+
+    _Wide.resize(Result.Written);
+
+    if (!IsJapanese())
+        return false;
+
+    repairedText.resize(GetUTF8Capacity(_Wide.size()));
+
+    Result = ::UTF16ToUTF8(_Wide.data(), _Wide.size(), repairedText.data());
+
+    repairedText.resize(Result.Written);
+
+    return true;
+}
+
+/// <summary>
+/// Converts the characters of the specified UTF-8 text back to Latin-1 or Windows-1252 bytes.
+/// Returns false if the text contains only ASCII or a character outside of those code pages, i.e. if there is nothing to repair.
+/// </summary>
+bool mojibake_repairer_t::GetBytes(const char * text, size_t size) noexcept
+{
+    size_t i = ::SkipASCII(text, size);
+
+    if (i == size)
+        return false;
+
+    const uint8_t * Text = (const uint8_t *) text;
+
+    _Bytes.assign(text, i);
+
+    while (i < size)
+    {
+        uint32_t c = Text[i];
+        size_t Length;
+
+        if (c < 0x80)               Length = 1;
+        else
+        if ((c & 0xE0) == 0xC0)   { Length = 2; c &= 0x1F; }
+        else
+        if ((c & 0xF0) == 0xE0)   { Length = 3; c &= 0x0F; } // The Windows-1252 characters above U+00FF are all in the BMP.
+        else
+            return false;
+
+        if (i + Length > size)
+            return false;
+
+        for (size_t k = 1; k < Length; ++k)
+        {
+            const uint8_t d = Text[i + k];
+
+            if ((d & 0xC0) != 0x80)
+                return false;
+
+            c = (c << 6) | (d & 0x3F);
+        }
+
+        uint8_t Byte;
+
+        if (!GetByte(c, Byte))
+            return false;
+
+        _Bytes.push_back((char) Byte);
+
+        i += Length;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if the decoded text contains at least one full-width kana and no user-defined characters.
+/// Kanji alone aren't enough: Latin-1 and Windows-1252 texts with accented letters or curly quotes often happen to form valid kanji.
+/// </summary>
+bool mojibake_repairer_t::IsJapanese() const noexcept
+{
+    bool HasKana = false;
+
+    for (const char16_t c : _Wide)
+    {
+        if ((c >= 0xE000) && (c <= 0xF8FF))
+            return false;
+
+        if ((c >= 0x3041) && (c <= 0x30FE))
+            HasKana = true;
+    }
+
+    return HasKana;
+}
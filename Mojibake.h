@@ -0,0 +1,35 @@
+
+/** $VER: Mojibake.h (2026.10.17) P. Stuer - Repairs texts that were decoded with the wrong code page. **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Repairs texts in a Japanese encoding that were decoded as Latin-1 or Windows-1252, e.g. Shift-JIS tags read by a tagger that didn't know the encoding.
+/// The characters of such a text are turned back into the original bytes, which are re-decoded with the encoding found by the detector.
+/// The buffers are kept between calls so that a batch of texts can be repaired without allocations. Texts that contain only ASCII are skipped after a single scan.
+/// </summary>
+class mojibake_repairer_t
+{
+public:
+    mojibake_repairer_t() noexcept { }
+
+    mojibake_repairer_t(const mojibake_repairer_t &) = delete;
+    mojibake_repairer_t & operator=(const mojibake_repairer_t &) = delete;
+    mojibake_repairer_t(mojibake_repairer_t &&) = delete;
+    mojibake_repairer_t & operator=(mojibake_repairer_t &&) = delete;
+
+    bool Repair(const char * text, size_t size, std::string & repairedText) noexcept;
+
+private:
+    bool GetBytes(const char * text, size_t size) noexcept;
+    bool IsJapanese() const noexcept;
+
+private:
+    std::string _Bytes;             // The text converted back to the bytes it was decoded from.
+    std::vector<char16_t> _Wide;    // The bytes decoded with the detected encoding.
+};
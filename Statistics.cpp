@@ -0,0 +1,170 @@
+
+/** $VER: Statistics.cpp (2026.10.17) P. Stuer - Collects the event counters and latency histograms of a panel. **/
+
+#include "pch.h"
+
+#include "Statistics.h"
+#include "FormattedTextCache.h"
+#include "TitleFormatCache.h"
+
+#include <cstdio>
+
+#pragma hdrstop
+
+#pragma region statistics_t
+
+static void AppendHistogram(std::string & json, const latency_histogram_t & histogram)
+{
+    char Text[256];
+
+    ::snprintf(Text, sizeof(Text), "{\"count\":%llu,\"min\":%llu,\"mean\":%.1f,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"max\":%llu}",
+        (unsigned long long) histogram.GetCount(), (unsigned long long) histogram.GetMin(), histogram.GetMean(),
+        (unsigned long long) histogram.GetPercentile(50.), (unsigned long long) histogram.GetPercentile(90.), (unsigned long long) histogram.GetPercentile(99.),
+        (unsigned long long) histogram.GetMax());
+
+    json.append(Text);
+}
+
+/// <summary>
+/// Returns the statistics as a JSON object. Latencies are in microseconds. The cache counters are shared by all panels.
+/// </summary>
+std::string statistics_t::ToJSON(const event_queue_t & eventQueue) const
+{
+    std::string JSON = "{\"events\":{";
+
+    char Text[256];
+
+    for (size_t i = 0; i < (size_t) event_type_t::Count; ++i)
+    {
+        const auto & Counters = eventQueue.GetCounters((event_type_t) i);
+
+        ::snprintf(Text, sizeof(Text), "%s\"%s\":{\"received\":%llu,\"dropped\":%llu,\"coalesced\":%llu,\"deferred\":%llu,\"dispatched\":%llu,\"latency\":", (i != 0) ? "," : "",
+            GetName((event_type_t) i), (unsigned long long) Counters.Received, (unsigned long long) Counters.Dropped, (unsigned long long) Counters.Coalesced, (unsigned long long) Counters.Deferred, (unsigned long long) Counters.Dispatched);
+
+        JSON.append(Text);
+
+        AppendHistogram(JSON, _EventLatencies[i]);
+
+        JSON.append("}");
+    }
+
+    JSON.append("},\"hostCalls\":{");
+
+    for (size_t i = 0; i < (size_t) host_method_t::Count; ++i)
+    {
+        ::snprintf(Text, sizeof(Text), "%s\"%s\":", (i != 0) ? "," : "", GetName((host_method_t) i));
+
+        JSON.append(Text);
+
+        AppendHistogram(JSON, _HostCallDurations[i]);
+    }
+
+    ::snprintf(Text, sizeof(Text), "},\"scripts\":{\"executed\":%llu,\"failed\":%llu},\"throttleInterval\":%lld,", (unsigned long long) _ScriptsExecuted, (unsigned long long) _ScriptsFailed, (long long) eventQueue.GetThrottleInterval().count());
+
+    JSON.append(Text);
+
+    ::snprintf(Text, sizeof(Text), "\"caches\":{\"titleFormat\":{\"count\":%zu,\"hits\":%llu,\"misses\":%llu},\"formattedText\":{\"count\":%zu,\"hits\":%llu,\"misses\":%llu}}}",
+        _TitleFormatCache.GetCount(), (unsigned long long) _TitleFormatCache.GetHits(), (unsigned long long) _TitleFormatCache.GetMisses(),
+        _FormattedTextCache.GetCount(), (unsigned long long) _FormattedTextCache.GetHits(), (unsigned long long) _FormattedTextCache.GetMisses());
+
+    JSON.append(Text);
+
+    return JSON;
+}
+
+/// <summary>
+/// Returns the statistics as text, one line per event type or host method. Only the lines with activity are included.
+/// </summary>
+std::string statistics_t::ToText(const event_queue_t & eventQueue) const
+{
+    std::string Result;
+
+    char Text[512];
+
+    for (size_t i = 0; i < (size_t) event_type_t::Count; ++i)
+    {
+        const auto & Counters = eventQueue.GetCounters((event_type_t) i);
+        const auto & Latency = _EventLatencies[i];
+
+        if (Counters.Received == 0)
+            continue;
+
+        ::snprintf(Text, sizeof(Text), "%-26s %8llu received, %8llu dropped, %8llu coalesced, %8llu deferred, %8llu dispatched; latency p50 %llu us, p90 %llu us, p99 %llu us, max %llu us\n", GetName((event_type_t) i),
+            (unsigned long long) Counters.Received, (unsigned long long) Counters.Dropped, (unsigned long long) Counters.Coalesced, (unsigned long long) Counters.Deferred, (unsigned long long) Counters.Dispatched,
+            (unsigned long long) Latency.GetPercentile(50.), (unsigned long long) Latency.GetPercentile(90.), (unsigned long long) Latency.GetPercentile(99.), (unsigned long long) Latency.GetMax());
+
+        Result.append(Text);
+    }
+
+    for (size_t i = 0; i < (size_t) host_method_t::Count; ++i)
+    {
+        const auto & Duration = _HostCallDurations[i];
+
+        if (Duration.GetCount() == 0)
+            continue;
+
+        ::snprintf(Text, sizeof(Text), "%-26s %8llu calls; duration p50 %llu us, p90 %llu us, p99 %llu us, max %llu us\n", GetName((host_method_t) i),
+            (unsigned long long) Duration.GetCount(), (unsigned long long) Duration.GetPercentile(50.), (unsigned long long) Duration.GetPercentile(90.), (unsigned long long) Duration.GetPercentile(99.), (unsigned long long) Duration.GetMax());
+
+        Result.append(Text);
+    }
+
+    ::snprintf(Text, sizeof(Text), "%-26s %8zu entries, %8llu hits, %8llu misses\n", "Title format cache", _TitleFormatCache.GetCount(), (unsigned long long) _TitleFormatCache.GetHits(), (unsigned long long) _TitleFormatCache.GetMisses());
+
+    Result.append(Text);
+
+    ::snprintf(Text, sizeof(Text), "%-26s %8zu entries, %8llu hits, %8llu misses\n", "Formatted text cache", _FormattedTextCache.GetCount(), (unsigned long long) _FormattedTextCache.GetHits(), (unsigned long long) _FormattedTextCache.GetMisses());
+
+    Result.append(Text);
+
+    ::snprintf(Text, sizeof(Text), "%llu scripts executed, %llu failed", (unsigned long long) _ScriptsExecuted, (unsigned long long) _ScriptsFailed);
+
+    Result.append(Text);
+
+    return Result;
+}
+
+/// <summary>
+/// Gets the name of an event type.
+/// </summary>
+const char * statistics_t::GetName(event_type_t type) noexcept
+{
+    static const char * const Names[] =
+    {
+        "PlaybackStarting",
+        "PlaybackNewTrack",
+        "PlaybackStop",
+        "PlaybackSeek",
+        "PlaybackPause",
+        "PlaybackEdited",
+        "PlaybackDynamicInfo",
+        "PlaybackDynamicTrackInfo",
+        "PlaybackTime",
+        "VolumeChange",
+        "PlaylistFocusedItemChanged",
+    };
+
+    static_assert(_countof(Names) == (size_t) event_type_t::Count, "Event name table is out of sync with event_type_t");
+
+    return Names[(size_t) type];
+}
+
+/// <summary>
+/// Gets the name of a host object method.
+/// </summary>
+const char * statistics_t::GetName(host_method_t method) noexcept
+{
+    static const char * const Names[] =
+    {
+        "GetFormattedText",
+        "GetFormattedTexts",
+        "RegisterFields",
+        "GetStatistics",
+    };
+
+    static_assert(_countof(Names) == (size_t) host_method_t::Count, "Method name table is out of sync with host_method_t");
+
+    return Names[(size_t) method];
+}
+
+#pragma endregion
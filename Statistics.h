@@ -0,0 +1,89 @@
+
+/** $VER: Statistics.h (2026.10.17) P. Stuer - Collects the event counters and latency histograms of a panel. **/
+
+#pragma once
+
+#include "EventQueue.h"
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Identifies the methods of the host object.
+/// </summary>
+enum class host_method_t : size_t
+{
+    GetFormattedText = 0,
+    GetFormattedTexts,
+    RegisterFields,
+    GetStatistics,
+
+    Count
+};
+
+/// <summary>
+/// Collects the statistics of a panel: the latency from a playback callback until the template has executed it, the duration of the host object calls and the script failures.
+/// The event counters are kept by the event queue.
+/// </summary>
+class statistics_t
+{
+public:
+    statistics_t() noexcept : _ScriptsExecuted(), _ScriptsFailed() { }
+
+    statistics_t(const statistics_t &) = delete;
+    statistics_t & operator=(const statistics_t &) = delete;
+    statistics_t(statistics_t &&) = delete;
+    statistics_t & operator=(statistics_t &&) = delete;
+
+    void RecordEventLatency(event_type_t type, uint64_t microseconds) noexcept { _EventLatencies[(size_t) type].Record(microseconds); }
+    void RecordHostCall(host_method_t method, uint64_t microseconds) noexcept { _HostCallDurations[(size_t) method].Record(microseconds); }
+    void RecordScript(bool succeeded) noexcept { ++(succeeded ? _ScriptsExecuted : _ScriptsFailed); }
+
+    std::string ToJSON(const event_queue_t & eventQueue) const;
+    std::string ToText(const event_queue_t & eventQueue) const;
+
+    static const char * GetName(event_type_t type) noexcept;
+    static const char * GetName(host_method_t method) noexcept;
+
+    /// <summary>
+    /// Gets the number of microseconds elapsed between the specified times.
+    /// </summary>
+    static uint64_t GetElapsed(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now()) noexcept
+    {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+private:
+    std::array<latency_histogram_t, (size_t) event_type_t::Count> _EventLatencies;
+    std::array<latency_histogram_t, (size_t) host_method_t::Count> _HostCallDurations;
+
+    uint64_t _ScriptsExecuted;
+    uint64_t _ScriptsFailed;
+};
+
+/// <summary>
+/// Records the duration of a host object call.
+/// </summary>
+class host_call_timer_t
+{
+public:
+    host_call_timer_t(statistics_t & statistics, host_method_t method) noexcept : _Statistics(statistics), _Method(method), _Start(std::chrono::steady_clock::now()) { }
+
+    ~host_call_timer_t() noexcept
+    {
+        _Statistics.RecordHostCall(_Method, statistics_t::GetElapsed(_Start));
+    }
+
+    host_call_timer_t(const host_call_timer_t &) = delete;
+    host_call_timer_t & operator=(const host_call_timer_t &) = delete;
+    host_call_timer_t(host_call_timer_t &&) = delete;
+    host_call_timer_t & operator=(host_call_timer_t &&) = delete;
+
+private:
+    statistics_t & _Statistics;
+    host_method_t _Method;
+    std::chrono::steady_clock::time_point _Start;
+};
@@ -0,0 +1,150 @@
+
+/** $VER: TaskQueue.cpp (2026.10.17) P. Stuer - Bounded lock-free queue of tasks to run on the window thread. **/
+
+#include "TaskQueue.h"
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+task_queue_t::task_queue_t() noexcept : _EnqueuePosition(0), _DequeuePosition(0), _IsWakeupPending(false), _IsOverflowing(false), _TasksQueued(0), _Wakeups(0), _Overflows(0)
+{
+    for (size_t i = 0; i < Capacity; ++i)
+    {
+        _Slots[i].Sequence.store(i, std::memory_order_relaxed);
+        _Slots[i].Execute = nullptr;
+    }
+}
+
+/// <summary>
+/// Destroys this instance. Tasks that have not run yet are discarded.
+/// </summary>
+task_queue_t::~task_queue_t() noexcept
+{
+    Clear();
+}
+
+/// <summary>
+/// Runs all queued tasks in the order they were pushed. Returns the number of tasks that were run. Must be called from the thread that owns the queue.
+/// </summary>
+size_t task_queue_t::Drain() noexcept
+{
+    // Reset the wakeup before looking at the slots so a task pushed while draining requests a new one. The exchange also makes the tasks of the producer that requested the wakeup visible.
+    _IsWakeupPending.exchange(false, std::memory_order_acq_rel);
+
+    size_t Count = Consume(true);
+
+    if (!_IsOverflowing.load(std::memory_order_acquire))
+        return Count;
+
+    // The overflow tasks were pushed after the tasks in the ring. If a producer is still writing a slot, wait for the wakeup it will request once it has published it.
+    if (_EnqueuePosition.load(std::memory_order_acquire) != _DequeuePosition)
+        return Count;
+
+    std::deque<std::function<void()>> Tasks;
+
+    {
+        std::lock_guard<std::mutex> Lock(_OverflowLock);
+
+        Tasks.swap(_OverflowTasks);
+
+        _IsOverflowing.store(false, std::memory_order_release);
+    }
+
+    for (auto & Task : Tasks)
+        Task();
+
+    return Count + Tasks.size();
+}
+
+/// <summary>
+/// Discards all queued tasks without running them.
+/// </summary>
+void task_queue_t::Clear() noexcept
+{
+    Consume(false);
+
+    std::lock_guard<std::mutex> Lock(_OverflowLock);
+
+    _OverflowTasks.clear();
+
+    _IsOverflowing.store(false, std::memory_order_release);
+}
+
+/// <summary>
+/// Reserves the next free slot. Returns nullptr if the queue is full.
+/// </summary>
+task_queue_t::slot_t * task_queue_t::Claim() noexcept
+{
+    size_t Position = _EnqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        slot_t * Slot = &_Slots[Position & (Capacity - 1)];
+
+        const size_t Sequence = Slot->Sequence.load(std::memory_order_acquire);
+
+        const intptr_t Difference = (intptr_t) Sequence - (intptr_t) Position;
+
+        if (Difference == 0)
+        {
+            if (_EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                return Slot;
+        }
+        else
+        if (Difference < 0)
+            return nullptr; // The slot still holds a task from the previous lap.
+        else
+            Position = _EnqueuePosition.load(std::memory_order_relaxed);
+    }
+}
+
+/// <summary>
+/// Makes a claimed slot available to the consumer.
+/// </summary>
+void task_queue_t::Publish(slot_t * slot) noexcept
+{
+    _TasksQueued.fetch_add(1, std::memory_order_relaxed);
+
+    slot->Sequence.store(slot->Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/// <summary>
+/// Adds a task that did not fit in the ring to the overflow list.
+/// </summary>
+void task_queue_t::PushOverflow(std::function<void()> && task) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_OverflowLock);
+
+    _OverflowTasks.push_back(std::move(task));
+
+    _IsOverflowing.store(true, std::memory_order_release);
+
+    _TasksQueued.fetch_add(1, std::memory_order_relaxed);
+    _Overflows.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Removes all published tasks from the queue, running them if requested.
+/// </summary>
+size_t task_queue_t::Consume(bool invoke) noexcept
+{
+    size_t Count = 0;
+
+    for (;;)
+    {
+        slot_t & Slot = _Slots[_DequeuePosition & (Capacity - 1)];
+
+        if (Slot.Sequence.load(std::memory_order_acquire) != _DequeuePosition + 1)
+            break;
+
+        Slot.Execute(Slot.Storage, invoke);
+        Slot.Execute = nullptr;
+
+        Slot.Sequence.store(_DequeuePosition + Capacity, std::memory_order_release);
+
+        ++_DequeuePosition;
+        ++Count;
+    }
+
+    return Count;
+}
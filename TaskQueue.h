@@ -0,0 +1,151 @@
+
+/** $VER: TaskQueue.h (2026.10.17) P. Stuer - Bounded lock-free queue of tasks to run on the window thread. **/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// <summary>
+/// Implements a bounded multiple-producer, single-consumer queue of tasks (D. Vyukov's bounded queue). Small callables are stored in the slots themselves; larger ones are moved to the heap.
+/// When the ring is full, tasks go to an overflow list protected by a lock until the consumer has emptied both, so the tasks of each producer always run in the order they were pushed.
+/// Any thread can push a task; only the thread that owns the queue may drain it. The queue also keeps track of a pending wakeup so the owner gets notified only once per drain.
+/// The queue depends only on the standard library.
+/// </summary>
+class task_queue_t
+{
+public:
+    task_queue_t() noexcept;
+    ~task_queue_t() noexcept;
+
+    task_queue_t(const task_queue_t &) = delete;
+    task_queue_t & operator=(const task_queue_t &) = delete;
+    task_queue_t(task_queue_t &&) = delete;
+    task_queue_t & operator=(task_queue_t &&) = delete;
+
+    /// <summary>
+    /// Adds a task to the queue.
+    /// </summary>
+    template<typename F>
+    void Push(F && task) noexcept
+    {
+        using task_type = std::decay_t<F>;
+
+        // Once a task has overflowed, the next ones follow it to the overflow list until the consumer has caught up.
+        slot_t * Slot = !_IsOverflowing.load(std::memory_order_acquire) ? Claim() : nullptr;
+
+        if (Slot == nullptr)
+        {
+            PushOverflow(std::function<void()>(std::forward<F>(task)));
+
+            return;
+        }
+
+        if constexpr ((sizeof(task_type) <= sizeof(Slot->Storage)) && (alignof(task_type) <= alignof(std::max_align_t)))
+        {
+            ::new (Slot->Storage) task_type(std::forward<F>(task));
+
+            Slot->Execute = &Execute<task_type>;
+        }
+        else
+        {
+            ::new (Slot->Storage) heap_task_t<task_type>(new task_type(std::forward<F>(task)));
+
+            Slot->Execute = &Execute<heap_task_t<task_type>>;
+        }
+
+        Publish(Slot);
+    }
+
+    /// <summary>
+    /// Marks a wakeup as pending. Returns true if the caller has to notify the owner, false if a notification is already on its way.
+    /// </summary>
+    bool RequestWakeup() noexcept
+    {
+        if (_IsWakeupPending.exchange(true, std::memory_order_acq_rel))
+            return false;
+
+        _Wakeups.fetch_add(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    size_t Drain() noexcept;
+    void Clear() noexcept;
+
+    uint64_t GetTasksQueued() const noexcept { return _TasksQueued.load(std::memory_order_relaxed); }
+    uint64_t GetWakeups() const noexcept { return _Wakeups.load(std::memory_order_relaxed); }
+    uint64_t GetOverflows() const noexcept { return _Overflows.load(std::memory_order_relaxed); }
+
+    static const size_t Capacity = 64; // Must be a power of 2.
+
+private:
+    struct alignas(64) slot_t
+    {
+        std::atomic<size_t> Sequence;
+        void (*Execute)(void * storage, bool invoke) noexcept;
+        alignas(std::max_align_t) unsigned char Storage[96];
+    };
+
+    /// <summary>
+    /// Wraps a callable that is too large to fit in a slot.
+    /// </summary>
+    template<typename F>
+    struct heap_task_t
+    {
+        explicit heap_task_t(F * task) noexcept : Task(task) { }
+        ~heap_task_t() { delete Task; }
+
+        heap_task_t(const heap_task_t &) = delete;
+        heap_task_t & operator=(const heap_task_t &) = delete;
+
+        void operator()() { (*Task)(); }
+
+        F * Task;
+    };
+
+    /// <summary>
+    /// Runs (optionally) and destroys the task stored in a slot.
+    /// </summary>
+    template<typename F>
+    static void Execute(void * storage, bool invoke) noexcept
+    {
+        F & Task = *std::launder(reinterpret_cast<F *>(storage));
+
+        if (invoke)
+            Task();
+
+        Task.~F();
+    }
+
+    slot_t * Claim() noexcept;
+    void Publish(slot_t * slot) noexcept;
+    void PushOverflow(std::function<void()> && task) noexcept;
+
+    size_t Consume(bool invoke) noexcept;
+
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+
+    slot_t _Slots[Capacity];
+
+    alignas(64) std::atomic<size_t> _EnqueuePosition;
+    alignas(64) size_t _DequeuePosition;
+
+    alignas(64) std::atomic<bool> _IsWakeupPending;
+
+    std::atomic<bool> _IsOverflowing;
+    std::mutex _OverflowLock;
+    std::deque<std::function<void()>> _OverflowTasks;  // The tasks that did not fit in the ring, in the order they were pushed.
+
+    std::atomic<uint64_t> _TasksQueued;
+    std::atomic<uint64_t> _Wakeups;
+    std::atomic<uint64_t> _Overflows;
+};
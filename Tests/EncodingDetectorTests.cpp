@@ -0,0 +1,149 @@
+
+/** $VER: EncodingDetectorTests.cpp (2026.10.17) P. Stuer - Tests the single-pass encoding detector. **/
+
+#include "Test.h"
+
+#include "EncodingDetector.h"
+#include "Validators.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace
+{
+    /// <summary>
+    /// The Shift-JIS MIDI title of the Data1 test case in Encoding.cpp.
+    /// </summary>
+    const char Data1[] = "Final Fantasy 5 [ \x83\x72\x83\x62\x83\x4f\x83\x75\x83\x8a\x83\x62\x83\x61\x82\xcc\x8e\x80\x93\xac \x81\x66\x82\x58\x82\x58 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// The same title in UTF-8.
+    /// </summary>
+    const char Text1[] = "Final Fantasy 5 [ \xE3\x83\x93\xE3\x83\x83\xE3\x82\xB0\xE3\x83\x96\xE3\x83\xAA\xE3\x83\x83\xE3\x83\x82\xE3\x81\xAE\xE6\xAD\xBB\xE9\x97\x98 \xE2\x80\x99\xEF\xBC\x99\xEF\xBC\x99 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    encoding_t Detect(const std::string & text) noexcept
+    {
+        return ::DetectEncoding(text.data(), text.size());
+    }
+
+    /// <summary>
+    /// Texts that are valid in a single encoding.
+    /// </summary>
+    void DetectsEncodings()
+    {
+        CHECK(Detect("") == encoding_t::ASCII);
+        CHECK(Detect("Final Fantasy") == encoding_t::ASCII);
+        CHECK(Detect(Data1) == encoding_t::ShiftJIS);
+        CHECK(Detect(Text1) == encoding_t::UTF8);
+        CHECK(Detect("\xA4\xA2\xA4\xA4") == encoding_t::EUCJP);            // あい: also valid Shift-JIS half-width katakana, but those don't score.
+        CHECK(Detect("\xFF\xFF") == encoding_t::Unknown);
+    }
+
+    /// <summary>
+    /// A character that is cut off at the end of the text eliminates its encoding, even when it is the only candidate left.
+    /// </summary>
+    void TruncatedCharactersAreRejected()
+    {
+        CHECK(Detect("\x83") == encoding_t::Unknown);
+        CHECK(Detect("abc\x83") == encoding_t::Unknown);
+        CHECK(Detect("\x83\x72\x83") == encoding_t::Unknown);
+
+        encoding_detector_t Detector;
+
+        Detector.Feed("\xE3\x81", 2);
+        Detector.Finish();
+
+        CHECK(!Detector.IsCandidate(encoding_t::UTF8));
+        CHECK(Detector.IsDone());
+    }
+
+    /// <summary>
+    /// A single remaining candidate is still eliminated by an invalid byte further on.
+    /// </summary>
+    void LastCandidateIsStillValidated()
+    {
+        encoding_detector_t Detector;
+
+        Detector.Feed("\x83\x72", 2);
+
+        CHECK(Detector.IsCandidate(encoding_t::ShiftJIS));
+        CHECK(!Detector.IsCandidate(encoding_t::UTF8));
+        CHECK(!Detector.IsCandidate(encoding_t::EUCJP));
+        CHECK(!Detector.IsDone());
+
+        Detector.Feed(" -single edit- \xFF", 16);
+
+        CHECK(Detector.IsDone());
+
+        Detector.Finish();
+
+        CHECK(Detector.GetEncoding() == encoding_t::Unknown);
+    }
+
+    /// <summary>
+    /// Feeding a text in chunks gives the same result as feeding it at once, and a detected encoding always validates.
+    /// </summary>
+    void ChunksGiveTheSameResult()
+    {
+        std::mt19937 Random(2026);
+
+        auto Next = [&Random](uint32_t lo, uint32_t hi) { return (uint32_t) std::uniform_int_distribution<uint32_t>(lo, hi)(Random); };
+
+        const std::string Samples[] = { Data1, Text1, "\xA4\xA2\xA4\xA4 \x8E\xB1 \x8F\xA1\xA1" };
+
+        int Mismatches = 0;
+
+        for (int n = 0; n < 20000; ++n)
+        {
+            std::string Text = Samples[n % 3];
+
+            // Change a byte or cut the text short.
+            if (Next(0, 1) == 0)
+                Text[Next(0, (uint32_t) Text.size() - 1)] = (char) Next(0x80, 0xFF);
+            else
+                Text.resize(Next(0, (uint32_t) Text.size()));
+
+            const encoding_t Expected = Detect(Text);
+
+            encoding_detector_t Detector;
+
+            for (size_t i = 0; i < Text.size();)
+            {
+                const size_t Size = (std::min)((size_t) Next(1, 7), Text.size() - i);
+
+                Detector.Feed(Text.data() + i, Size);
+
+                i += Size;
+            }
+
+            Detector.Finish();
+
+            bool IsValid = true;
+
+            switch (Expected)
+            {
+                case encoding_t::ASCII:    IsValid = ::IsASCII(Text.data(), Text.size()); break;
+                case encoding_t::UTF8:     IsValid = ::IsUTF8(Text.data(), Text.size()); break;
+                case encoding_t::ShiftJIS: IsValid = ::IsShiftJIS(Text.data(), Text.size()); break;
+                case encoding_t::EUCJP:    IsValid = ::IsEUCJP(Text.data(), Text.size()); break;
+                default: break;
+            }
+
+            if ((Detector.GetEncoding() != Expected) || !IsValid)
+                ++Mismatches;
+        }
+
+        CHECK(Mismatches == 0);
+    }
+}
+
+int main()
+{
+    RUN(DetectsEncodings);
+    RUN(TruncatedCharactersAreRejected);
+    RUN(LastCandidateIsStillValidated);
+    RUN(ChunksGiveTheSameResult);
+
+    return test::GetExitCode();
+}
@@ -0,0 +1,552 @@
+
+/** $VER: EventQueueTests.cpp (2026.10.17) P. Stuer - Tests the event queue with a simulated clock and a fake sink. **/
+
+#include "Test.h"
+
+#include "EventQueue.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /// <summary>
+    /// Implements a clock that only advances when told to.
+    /// </summary>
+    class simulated_clock_t : public event_clock_t
+    {
+    public:
+        simulated_clock_t() noexcept : _Now(event_time_t() + 1h) { }
+
+        event_time_t Now() const noexcept override { return _Now; }
+
+        void Advance(std::chrono::milliseconds duration) noexcept { _Now += duration; }
+
+    private:
+        event_time_t _Now;
+    };
+
+    /// <summary>
+    /// Implements a sink that records the requests of the queue instead of talking to a WebView.
+    /// </summary>
+    class fake_sink_t : public event_sink_t
+    {
+    public:
+        void RequestFlush() noexcept override { ++FlushRequests; }
+
+        void RequestDelayedFlush(uint32_t milliseconds) noexcept override { DelayedFlushes.push_back(milliseconds); }
+
+        bool ExecuteScript(const std::wstring & script, const std::vector<dispatched_event_t> & events, const script_ticket_t & ticket) noexcept override
+        {
+            if (!IsAvailable)
+                return false;
+
+            Scripts.push_back(script);
+            Events.push_back(events);
+            Tickets.push_back(ticket);
+
+            return true;
+        }
+
+        /// <summary>
+        /// Gets the types of the events of the last script, in the order they were sent.
+        /// </summary>
+        std::vector<event_type_t> GetLastTypes() const
+        {
+            std::vector<event_type_t> Types;
+
+            if (!Events.empty())
+                for (const auto & Event : Events.back())
+                    Types.push_back(Event.Type);
+
+            return Types;
+        }
+
+        bool IsAvailable = true;
+
+        size_t FlushRequests = 0;
+        std::vector<uint32_t> DelayedFlushes;
+        std::vector<std::wstring> Scripts;
+        std::vector<std::vector<dispatched_event_t>> Events;
+        std::vector<script_ticket_t> Tickets;
+    };
+
+    /// <summary>
+    /// Superseded events are merged: the last seek wins and repeated refresh events collapse into one call.
+    /// </summary>
+    void LastEventWins()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(1)");
+        Queue.Enqueue(event_type_t::PlaybackDynamicInfo, L"OnPlaybackDynamicInfo()");
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(2)");
+        Queue.Enqueue(event_type_t::PlaybackDynamicInfo, L"OnPlaybackDynamicInfo()");
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(3)");
+
+        // Only the first event of each type asks for a flush.
+        CHECK(Sink.FlushRequests == 2);
+
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 1);
+
+        const std::wstring & Script = Sink.Scripts.back();
+
+        CHECK(Script.find(L"OnPlaybackSeek(3)") != std::wstring::npos);
+        CHECK(Script.find(L"OnPlaybackSeek(1)") == std::wstring::npos);
+        CHECK(Script.find(L"OnPlaybackSeek(2)") == std::wstring::npos);
+        CHECK(Script.find(L"OnPlaybackDynamicInfo()") == Script.rfind(L"OnPlaybackDynamicInfo()"));
+
+        CHECK(Queue.GetCounters(event_type_t::PlaybackSeek).Coalesced == 2);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackDynamicInfo).Coalesced == 1);
+
+        // A flush without pending events doesn't execute a script.
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 1);
+    }
+
+    /// <summary>
+    /// The queue reports the events it received and the scripts it actually executed.
+    /// </summary>
+    void ReportsEventsReceivedAndScriptsExecuted()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        for (int Turn = 0; Turn < 5; ++Turn)
+        {
+            for (int i = 0; i < 20; ++i)
+                Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(" + std::to_wstring(i) + L")");
+
+            Queue.Enqueue(event_type_t::PlaylistFocusedItemChanged, L"OnPlaylistFocusedItemChanged()");
+
+            Queue.Flush();
+        }
+
+        CHECK(Queue.GetEventsReceived() == 105);
+        CHECK(Queue.GetScriptsExecuted() == 5);
+        CHECK(Sink.Scripts.size() == 5);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackSeek).Dispatched == 5);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackSeek).Coalesced == 95);
+    }
+
+    /// <summary>
+    /// Events the template doesn't handle are counted and discarded without asking for a flush.
+    /// </summary>
+    void UnsubscribedEventsAreDropped()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(1u << (uint32_t) event_type_t::PlaybackNewTrack);
+
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(1)");
+        Queue.Enqueue(event_type_t::VolumeChange, L"OnVolumeChange(0)");
+
+        CHECK(Queue.IsEmpty());
+        CHECK(Sink.FlushRequests == 0);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackTime).Received == 1);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackTime).Dropped == 1);
+
+        Queue.Enqueue(event_type_t::PlaybackNewTrack, L"OnPlaybackNewTrack()");
+        Queue.Flush();
+
+        CHECK(Sink.GetLastTypes() == std::vector<event_type_t>{ event_type_t::PlaybackNewTrack });
+        CHECK(Queue.GetEventsReceived() == 3);
+    }
+
+    /// <summary>
+    /// A script the sink can't execute is not counted as executed.
+    /// </summary>
+    void FailedScriptsAreNotCounted()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Sink.IsAvailable = false;
+
+        Queue.Enqueue(event_type_t::PlaybackStop, L"OnPlaybackStop(\"User\")");
+        Queue.Flush();
+
+        CHECK(Queue.GetScriptsExecuted() == 0);
+        CHECK(Queue.GetEventsReceived() == 1);
+        CHECK(Queue.IsEmpty());
+    }
+
+    /// <summary>
+    /// Ambient events go after the other events, whatever order they arrived in. The other events keep their order of arrival.
+    /// </summary>
+    void AmbientEventsGoLast()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(1)");
+        Queue.Enqueue(event_type_t::VolumeChange, L"OnVolumeChange(-3)");
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(10)");
+        Queue.Enqueue(event_type_t::PlaybackNewTrack, L"OnPlaybackNewTrack()");
+        Queue.Enqueue(event_type_t::PlaybackPause, L"OnPlaybackPause(true)");
+
+        Queue.Flush();
+
+        const std::vector<event_type_t> Expected =
+        {
+            event_type_t::PlaybackSeek, event_type_t::PlaybackNewTrack, event_type_t::PlaybackPause,   // Critical and interactive, in order of arrival
+            event_type_t::PlaybackTime, event_type_t::VolumeChange,                                     // Ambient, in order of arrival
+        };
+
+        CHECK(Sink.Scripts.size() == 1);
+        CHECK(Sink.GetLastTypes() == Expected);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackNewTrack()") < Sink.Scripts.back().find(L"OnPlaybackTime(1)"));
+        CHECK(Queue.IsEmpty());
+    }
+
+    /// <summary>
+    /// A seek that precedes a track change is sent before it, so the template doesn't apply the seek to the new track.
+    /// </summary>
+    void SeekGoesBeforeNewTrack()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(120)");
+        Queue.Enqueue(event_type_t::PlaybackNewTrack, L"OnPlaybackNewTrack()");
+
+        Queue.Flush();
+
+        CHECK(Sink.GetLastTypes() == (std::vector<event_type_t>{ event_type_t::PlaybackSeek, event_type_t::PlaybackNewTrack }));
+
+        // A seek in the new track goes after it.
+        Queue.Enqueue(event_type_t::PlaybackNewTrack, L"OnPlaybackNewTrack()");
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(0)");
+
+        Queue.Flush();
+
+        CHECK(Sink.GetLastTypes() == (std::vector<event_type_t>{ event_type_t::PlaybackNewTrack, event_type_t::PlaybackSeek }));
+    }
+
+    /// <summary>
+    /// A pause that precedes a stop is sent before it, so the template ends up in the stopped state.
+    /// </summary>
+    void PauseGoesBeforeStop()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackPause, L"OnPlaybackPause(true)");
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(42)");
+        Queue.Enqueue(event_type_t::PlaybackStop, L"OnPlaybackStop(\"User\")");
+
+        Queue.Flush();
+
+        const std::vector<event_type_t> Expected = { event_type_t::PlaybackPause, event_type_t::PlaybackStop, event_type_t::PlaybackTime };
+
+        CHECK(Sink.GetLastTypes() == Expected);
+    }
+
+    /// <summary>
+    /// A burst of ambient events results in a single call with the last value.
+    /// </summary>
+    void AmbientEventsCollapse()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(" + std::to_wstring(i) + L")");
+            Clock.Advance(10ms);
+        }
+
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 1);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackTime(10)") != std::wstring::npos);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackTime(9)") == std::wstring::npos);
+        CHECK(Queue.GetCounters(event_type_t::PlaybackTime).Coalesced == 9);
+
+        // The time stamp of the dispatched event is the time the first event of the burst became pending.
+        CHECK(Sink.Events.back()[0].Time == event_time_t() + 1h);
+    }
+
+    /// <summary>
+    /// While the page does not keep up, ambient events are held back until the throttle interval has passed on the simulated clock. Critical events are not.
+    /// </summary>
+    void CriticalEventsDoNotWaitForThrottledAmbientEvents()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        // Submit scripts that never complete until the page is congested.
+        for (int i = 0; i < 3; ++i)
+        {
+            Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(" + std::to_wstring(i) + L")");
+            Queue.Flush();
+        }
+
+        CHECK(Queue.GetThrottleInterval().count() != 0);
+
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(3)");
+        Queue.Enqueue(event_type_t::PlaybackNewTrack, L"OnPlaybackNewTrack()");
+
+        const size_t ScriptCount = Sink.Scripts.size();
+
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == ScriptCount + 1);
+        CHECK(Sink.GetLastTypes() == std::vector<event_type_t>{ event_type_t::PlaybackNewTrack });
+        CHECK(!Queue.IsEmpty());
+        CHECK(!Sink.DelayedFlushes.empty());
+
+        const auto Interval = Queue.GetThrottleInterval();
+
+        // Nothing is sent before the interval has passed...
+        Clock.Advance(Interval / 2);
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == ScriptCount + 1);
+
+        // ...and the held back event is sent once it has.
+        Clock.Advance(Interval / 2);
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == ScriptCount + 2);
+        CHECK(Sink.GetLastTypes() == std::vector<event_type_t>{ event_type_t::PlaybackTime });
+        CHECK(Queue.IsEmpty());
+    }
+
+    /// <summary>
+    /// Interactive events are never throttled.
+    /// </summary>
+    void InteractiveEventsAreNotThrottled()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(" + std::to_wstring(i) + L")");
+            Queue.Flush();
+        }
+
+        CHECK(Queue.GetThrottleInterval().count() != 0);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(3)");
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 4);
+        CHECK(Queue.IsEmpty());
+    }
+
+    /// <summary>
+    /// A burst of flushes and completions while the page is congested changes the throttle interval only once per measurement window.
+    /// </summary>
+    void ThrottleChangesOncePerWindow()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(" + std::to_wstring(i) + L")");
+            Queue.Flush();
+        }
+
+        CHECK(Queue.GetThrottleInterval() == 250ms);
+
+        // Slow completions within the same window don't change it either.
+        Clock.Advance(100ms);
+
+        Queue.OnScriptCompleted(Sink.Tickets[0]);
+        Queue.OnScriptCompleted(Sink.Tickets[1]);
+
+        CHECK(Queue.GetThrottleInterval() == 250ms);
+
+        // The next window doubles it once.
+        Clock.Advance(500ms);
+
+        Queue.OnScriptCompleted(Sink.Tickets[2]);
+        Queue.OnScriptCompleted(Sink.Tickets[3]);
+
+        CHECK(Queue.GetThrottleInterval() == 500ms);
+    }
+
+    /// <summary>
+    /// Completions of scripts submitted before the queue was cleared don't change the in-flight count of the new page.
+    /// </summary>
+    void StaleCompletionsAreIgnored()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(1)");
+        Queue.Flush();
+
+        const script_ticket_t Stale = Sink.Tickets.back();
+
+        Queue.Clear();
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(2)");
+        Queue.Flush();
+
+        CHECK(Queue.GetScriptsInFlight() == 1);
+
+        Queue.OnScriptCompleted(Stale);
+
+        CHECK(Queue.GetScriptsInFlight() == 1);
+
+        Queue.OnScriptCompleted(Sink.Tickets.back());
+
+        CHECK(Queue.GetScriptsInFlight() == 0);
+    }
+
+    /// <summary>
+    /// An ambient event that is held back during several flushes is counted as deferred once.
+    /// </summary>
+    void DeferralsAreCountedOnce()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(" + std::to_wstring(i) + L")");
+            Queue.Flush();
+        }
+
+        CHECK(Queue.GetThrottleInterval().count() != 0);
+
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(3)");
+
+        for (int i = 0; i < 5; ++i)
+        {
+            Queue.Flush();
+            Clock.Advance(10ms);
+        }
+
+        CHECK(Queue.GetCounters(event_type_t::PlaybackTime).Deferred == 1);
+
+        // Once sent, the next held back event is counted again.
+        Clock.Advance(Queue.GetThrottleInterval());
+        Queue.Flush();
+
+        CHECK(Queue.IsEmpty());
+
+        Queue.Enqueue(event_type_t::PlaybackTime, L"OnPlaybackTime(4)");
+        Queue.Flush();
+        Queue.Flush();
+
+        CHECK(Queue.GetCounters(event_type_t::PlaybackTime).Deferred == 2);
+    }
+
+    /// <summary>
+    /// Until the page has subscribed, the latest event of each type is held without asking for a flush. Subscribing sends the held events the page handles.
+    /// </summary>
+    void EventsAreHeldUntilSubscribed()
+    {
+        simulated_clock_t Clock;
+        fake_sink_t Sink;
+        event_queue_t Queue(Sink, Clock);
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(1)");
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(2)");
+        Queue.Enqueue(event_type_t::PlaylistFocusedItemChanged, L"OnPlaylistFocusedItemChanged()");
+        Queue.Enqueue(event_type_t::VolumeChange, L"OnVolumeChange(0)");
+
+        Queue.Flush();
+
+        CHECK(Sink.FlushRequests == 0);
+        CHECK(Sink.Scripts.empty());
+        CHECK(!Queue.IsEmpty());
+
+        Queue.SetSubscriptions((1u << (uint32_t) event_type_t::PlaybackSeek) | (1u << (uint32_t) event_type_t::PlaylistFocusedItemChanged));
+
+        CHECK(Sink.FlushRequests == 1);
+        CHECK(Queue.GetCounters(event_type_t::VolumeChange).Dropped == 1);
+
+        Queue.Flush();
+
+        const std::vector<event_type_t> Expected = { event_type_t::PlaybackSeek, event_type_t::PlaylistFocusedItemChanged };
+
+        CHECK(Sink.GetLastTypes() == Expected);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackSeek(2)") != std::wstring::npos);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackSeek(1)") == std::wstring::npos);
+
+        // Loading another template holds the events again.
+        Queue.Hold();
+
+        Queue.Enqueue(event_type_t::PlaybackSeek, L"OnPlaybackSeek(3)");
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 1);
+
+        Queue.SetSubscriptions(event_queue_t::AllEvents);
+        Queue.Flush();
+
+        CHECK(Sink.Scripts.size() == 2);
+        CHECK(Sink.Scripts.back().find(L"OnPlaybackSeek(3)") != std::wstring::npos);
+    }
+}
+
+int main()
+{
+    RUN(LastEventWins);
+    RUN(ReportsEventsReceivedAndScriptsExecuted);
+    RUN(UnsubscribedEventsAreDropped);
+    RUN(FailedScriptsAreNotCounted);
+    RUN(AmbientEventsGoLast);
+    RUN(SeekGoesBeforeNewTrack);
+    RUN(PauseGoesBeforeStop);
+    RUN(AmbientEventsCollapse);
+    RUN(CriticalEventsDoNotWaitForThrottledAmbientEvents);
+    RUN(InteractiveEventsAreNotThrottled);
+    RUN(ThrottleChangesOncePerWindow);
+    RUN(StaleCompletionsAreIgnored);
+    RUN(DeferralsAreCountedOnce);
+    RUN(EventsAreHeldUntilSubscribed);
+
+    return test::GetExitCode();
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+
+# $VER: GenerateCP932Table.py (2026.10.17) P. Stuer - Generates CP932Table.h from the Unicode mapping files.
+#
+# Usage: GenerateCP932Table.py <folder with CP932.TXT and JIS0208.TXT> > ../CP932Table.h
+#
+# CP932.TXT:   https://www.unicode.org/Public/MAPPINGS/VENDORS/MICSFT/WINDOWS/CP932.TXT
+# JIS0208.TXT: https://www.unicode.org/Public/MAPPINGS/OBSOLETE/EASTASIA/JIS/JIS0208.TXT
+
+import os
+import sys
+
+FirstUserDefinedRow = 95
+LastUserDefinedRow = 114
+RowCount = 120
+CellCount = 94
+
+def ReadMapping(filePath, columnCount):
+    """Reads the hexadecimal columns of a mapping file. Lines without a character (e.g. the undefined bytes of CP932.TXT) are skipped."""
+    Rows = []
+
+    with open(filePath, encoding = 'ascii') as File:
+        for Line in File:
+            Columns = Line.split('#', 1)[0].split()
+
+            if len(Columns) == columnCount:
+                Rows.append([int(Column, 16) for Column in Columns])
+
+    return Rows
+
+def GetRowAndCell(code):
+    """Gets the row ("ku") and the cell ("ten") of a double-byte Shift-JIS code."""
+    Lead = code >> 8
+    Trail = code & 0xFF
+
+    Row = ((Lead - 0x81) * 2 + 1) if (Lead <= 0x9F) else ((Lead - 0xE0) * 2 + 63)
+
+    if Trail >= 0x9F:
+        return Row + 1, Trail - 0x9E
+
+    return Row, (Trail - 0x3F) if (Trail < 0x7F) else (Trail - 0x40)
+
+def Main(folderPath):
+    Table = {}
+
+    for Code, CodePoint in ReadMapping(os.path.join(folderPath, 'CP932.TXT'), 2):
+        if Code > 0xFF:
+            Table[GetRowAndCell(Code)] = CodePoint
+
+    Rows = [Row for Row in range(1, RowCount + 1) if not (FirstUserDefinedRow <= Row <= LastUserDefinedRow) and any((Row, Cell) in Table for Cell in range(1, CellCount + 1))]
+
+    # The characters that JIS X 0208 maps differently. 1-32 (U+005C in JIS0208.TXT) is kept as U+FF3C, like code page 932 and iconv.
+    Overrides = []
+
+    for _, JIS, CodePoint in ReadMapping(os.path.join(folderPath, 'JIS0208.TXT'), 3):
+        Key = ((JIS >> 8) - 0x20, (JIS & 0xFF) - 0x20)
+
+        if (Key != (1, 32)) and (Table.get(Key, 0) != CodePoint):
+            Overrides.append((Key, CodePoint, Table.get(Key, 0)))
+
+    Lines = []
+
+    Lines.append('')
+    Lines.append('/** $VER: CP932Table.h (2026.10.17) P. Stuer - Maps the double-byte characters of code page 932 to Unicode. **/')
+    Lines.append('')
+    Lines.append('#pragma once')
+    Lines.append('')
+    Lines.append('#include <cstdint>')
+    Lines.append('')
+    Lines.append('// Generated by Tests/GenerateCP932Table.py from the Microsoft CP932 mapping (CP932.TXT): JIS X 0208 with the NEC and IBM extensions, indexed by row ("ku", 1 to 120) and cell ("ten", 1 to 94).')
+    Lines.append('// Rows 95 to 114 (lead bytes 0xF0 to 0xF9) are the user-defined area which maps to U+E000 to U+E757 without a table. 0 = no character.')
+    Lines.append('')
+
+    Index = [0xFF] * (RowCount + 1)
+
+    for i, Row in enumerate(Rows):
+        Index[Row] = i
+
+    Lines.append('static const uint8_t CP932RowIndex[%d] =' % (RowCount + 1))
+    Lines.append('{')
+
+    for i in range(0, len(Index), 16):
+        Lines.append('    ' + ' '.join('0x%02X,' % Value for Value in Index[i:i + 16]))
+
+    Lines.append('};')
+    Lines.append('')
+    Lines.append('static const uint16_t CP932Rows[%d][%d] =' % (len(Rows), CellCount))
+    Lines.append('{')
+
+    for Row in Rows:
+        Values = [Table.get((Row, Cell), 0) for Cell in range(1, CellCount + 1)]
+
+        Lines.append('    // Row %d' % Row)
+        Lines.append('    {')
+
+        for i in range(0, CellCount, 16):
+            Lines.append('        ' + ' '.join('0x%04X,' % Value for Value in Values[i:i + 16]))
+
+        Lines.append('    },')
+
+    Lines.append('};')
+    Lines.append('')
+    Lines.append('// The characters that code page 932 maps differently from JIS X 0208 (JIS0208.TXT). Used by the EUC-JP decoder.')
+    Lines.append('static const struct { uint8_t Row; uint8_t Cell; uint16_t CodePoint; } JISX0208Overrides[] =')
+    Lines.append('{')
+
+    for (Row, Cell), CodePoint, CP932CodePoint in sorted(Overrides):
+        Lines.append('    { %3d, %3d, 0x%04X }, // U+%04X in code page 932' % (Row, Cell, CodePoint, CP932CodePoint))
+
+    Lines.append('};')
+
+    sys.stdout.write('\n'.join(Lines) + '\n')
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit('Usage: GenerateCP932Table.py <folder with CP932.TXT and JIS0208.TXT>')
+
+    Main(sys.argv[1])
@@ -0,0 +1,263 @@
+
+/** $VER: JapaneseDecoderBenchmark.cpp (2026.10.17) P. Stuer - Compares the throughput of the Shift-JIS and EUC-JP decoders with the converter of the operating system. **/
+
+#include "SystemConverter.h"
+
+#include "JapaneseDecoder.h"
+#include "Mojibake.h"
+#include "Validators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t CorpusSize = 1 << 20;
+
+    /// <summary>
+    /// The Shift-JIS MIDI title of the Data1 test case in Encoding.cpp: mostly ASCII with a few Japanese words.
+    /// </summary>
+    const unsigned char Data1[] =
+    {
+        0x46, 0x69, 0x6e, 0x61, 0x6c, 0x20, 0x46, 0x61, 0x6e, 0x74, 0x61, 0x73, 0x79, 0x20, 0x35, 0x20, 0x5b, 0x20, 0x83, 0x72, 0x83, 0x62, 0x83, 0x4f,
+        0x83, 0x75, 0x83, 0x8a, 0x83, 0x62, 0x83, 0x61, 0x82, 0xcc, 0x8e, 0x80, 0x93, 0xac, 0x20, 0x81, 0x66, 0x82, 0x58, 0x82, 0x58, 0x20, 0x2d, 0x73,
+        0x69, 0x6e, 0x67, 0x6c, 0x65, 0x20, 0x65, 0x64, 0x69, 0x74, 0x2d, 0x20, 0x5d, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x53, 0x43, 0x2d, 0x38, 0x38, 0x50,
+        0x72, 0x6f, 0x20, 0x32, 0x50, 0x6f, 0x72, 0x74, 0x20, 0x76, 0x65, 0x72, 0x37, 0x2e, 0x30, 0x20, 0x62, 0x79, 0x20, 0x4c, 0x69, 0x78,
+    };
+
+    /// <summary>
+    /// Titles that the mojibake repairer checks: clean ASCII, clean UTF-8 and Data1 decoded as Latin-1.
+    /// </summary>
+    const char ASCIITitle[]    = "Final Fantasy 5 - Battle at the Big Bridge -single edit- for SC-88Pro 2Port ver7.0 by Lix";
+    const char LatinTitle[]    = "Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9" "e - Caf\xC3\xA9 del Mar - Bj\xC3\xB6rk - J\xC3\xB3ga - Se\xC3\xB1or";
+    const char JapaneseTitle[] = "Final Fantasy 5 [ \xE3\x83\x93\xE3\x83\x83\xE3\x82\xB0\xE3\x83\x96\xE3\x83\xAA\xE3\x83\x83\xE3\x83\x82\xE3\x81\xAE\xE6\xAD\xBB\xE9\x97\x98 \xE2\x80\x99\xEF\xBC\x99\xEF\xBC\x99 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// Repeats the specified text until the corpus is full.
+    /// </summary>
+    std::string Repeat(const char * text, size_t size)
+    {
+        std::string Corpus;
+
+        while (Corpus.size() + size <= CorpusSize)
+            Corpus.append(text, size);
+
+        return Corpus;
+    }
+
+    /// <summary>
+    /// Builds a Japanese text of hiragana and level 1 kanji with a space every 32 characters.
+    /// </summary>
+    std::string MakeJapanese(test::system_encoding_t encoding)
+    {
+        std::mt19937 Random(2026);
+
+        std::string Corpus;
+
+        for (size_t n = 0; Corpus.size() + 8 <= CorpusSize; ++n)
+        {
+            if (n % 32 == 31)
+            {
+                Corpus.push_back(' ');
+                continue;
+            }
+
+            const bool IsHiragana = (Random() % 2 == 0);
+
+            if (encoding == test::system_encoding_t::ShiftJIS)
+            {
+                // Hiragana (0x829F to 0x82F1) or kanji (rows 17 to 46, lead bytes 0x89 to 0x97).
+                if (IsHiragana)
+                {
+                    Corpus.push_back((char) 0x82);
+                    Corpus.push_back((char) (0x9F + Random() % 0x53));
+                }
+                else
+                {
+                    const uint32_t Trail = 0x40 + Random() % 0xBC;
+
+                    Corpus.push_back((char) (0x89 + Random() % 0x0F));
+                    Corpus.push_back((char) ((Trail >= 0x7F) ? Trail + 1 : Trail));
+                }
+            }
+            else
+            {
+                // Hiragana (row 4) or kanji (rows 16 to 46).
+                Corpus.push_back((char) (IsHiragana ? 0xA4 : 0xB0 + Random() % 0x1F));
+                Corpus.push_back((char) (0xA1 + Random() % 0x53));
+            }
+        }
+
+        return Corpus;
+    }
+
+    /// <summary>
+    /// Gets the time of a single call in ns.
+    /// </summary>
+    template<typename F>
+    double MeasureCall(F call)
+    {
+        double Best = 1e9;
+
+        for (int Run = 0; Run < 5; ++Run)
+        {
+            const int Iterations = 100000;
+
+            const auto Start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < Iterations; ++i)
+                call();
+
+            const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+            Best = (std::min)(Best, Elapsed * 1e9 / Iterations);
+        }
+
+        return Best;
+    }
+
+    /// <summary>
+    /// Gets the throughput of a conversion in MB/s of input. The conversion returns false if it fails.
+    /// </summary>
+    template<typename F>
+    double Measure(F convert, size_t size)
+    {
+        double Best = 0.;
+
+        for (int Run = 0; Run < 5; ++Run)
+        {
+            const int Iterations = 20;
+
+            const auto Start = std::chrono::steady_clock::now();
+
+            bool Result = true;
+
+            for (int i = 0; i < Iterations; ++i)
+                Result &= convert();
+
+            const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+            if (!Result)
+                return 0.;
+
+            Best = (std::max)(Best, (double) size * Iterations / Elapsed / 1e6);
+        }
+
+        return Best;
+    }
+}
+
+int main()
+{
+    const std::string ASCII = Repeat("The quick brown fox jumps over the lazy dog. 0123456789 ", 56);
+
+    const struct
+    {
+        const char * Name;
+        test::system_encoding_t Encoding;
+        transcode_result_t (* Decoder)(const char *, size_t, char16_t *) noexcept;
+        const char * CorpusName;
+        std::string Corpus;
+    }
+    Cases[] =
+    {
+        { "Shift-JIS", test::system_encoding_t::ShiftJIS, ::ShiftJISToUTF16, "ASCII",    ASCII },
+        { "Shift-JIS", test::system_encoding_t::ShiftJIS, ::ShiftJISToUTF16, "Data1",    Repeat((const char *) Data1, sizeof(Data1)) },
+        { "Shift-JIS", test::system_encoding_t::ShiftJIS, ::ShiftJISToUTF16, "Japanese", MakeJapanese(test::system_encoding_t::ShiftJIS) },
+        { "EUC-JP",    test::system_encoding_t::EUCJP,    ::EUCJPToUTF16,    "ASCII",    ASCII },
+        { "EUC-JP",    test::system_encoding_t::EUCJP,    ::EUCJPToUTF16,    "Japanese", MakeJapanese(test::system_encoding_t::EUCJP) },
+    };
+
+    std::vector<instruction_set_t> InstructionSets;
+
+    for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+    {
+        ::SetInstructionSet(InstructionSet);
+
+        if (::GetInstructionSet() == InstructionSet)
+            InstructionSets.push_back(InstructionSet);
+    }
+
+    ::printf("MB/s on %zu KB        ", CorpusSize / 1024);
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf(" %8s", ::GetInstructionSetName(InstructionSet));
+
+    ::printf(" %8s\n", "System");
+
+    for (const auto & Case : Cases)
+    {
+        ::printf("%-9s %-11s", Case.Name, Case.CorpusName);
+
+        std::u16string Buffer(GetJapaneseUTF16Capacity(Case.Corpus.size()), u'\0');
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            ::printf(" %8.0f", Measure([&] { return Case.Decoder(Case.Corpus.data(), Case.Corpus.size(), Buffer.data()).IsValid(); }, Case.Corpus.size()));
+        }
+
+        std::u16string Result;
+
+        ::printf(" %8.0f\n", Measure([&] { return test::SystemToUTF16(Case.Encoding, Case.Corpus, Result); }, Case.Corpus.size()));
+    }
+
+    // The mojibake repairer runs on every title when the preference is enabled. Clean titles should only cost a scan.
+    std::string Mojibake;
+
+    for (const unsigned char c : Data1)
+    {
+        if (c >= 0x80)
+        {
+            Mojibake.push_back((char) (0xC0 | (c >> 6)));
+            Mojibake.push_back((char) (0x80 | (c & 0x3F)));
+        }
+        else
+            Mojibake.push_back((char) c);
+    }
+
+    const struct
+    {
+        const char * Name;
+        std::string Title;
+    }
+    Titles[] =
+    {
+        { "ASCII",    ASCIITitle },
+        { "Latin",    LatinTitle },
+        { "Japanese", JapaneseTitle },
+        { "Mojibake", Mojibake },
+    };
+
+    ::printf("\nns per title          ");
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf(" %8s", ::GetInstructionSetName(InstructionSet));
+
+    ::printf(" %8s\n", "Copy");
+
+    for (const auto & Title : Titles)
+    {
+        ::printf("%-9s %-11s", "Mojibake", Title.Name);
+
+        mojibake_repairer_t Repairer;
+        std::string RepairedText;
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            ::printf(" %8.1f", MeasureCall([&] { Repairer.Repair(Title.Title.data(), Title.Title.size(), RepairedText); }));
+        }
+
+        // The cost of copying the title, as a reference.
+        ::printf(" %8.1f\n", MeasureCall([&] { RepairedText.assign(Title.Title); }));
+    }
+
+    return 0;
+}
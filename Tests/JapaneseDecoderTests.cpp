@@ -0,0 +1,463 @@
+
+/** $VER: JapaneseDecoderTests.cpp (2026.10.17) P. Stuer - Compares the Shift-JIS and EUC-JP decoders with the Unicode mapping files and with the converter of the operating system. **/
+
+#include "Test.h"
+#include "SystemConverter.h"
+
+#include "JapaneseDecoder.h"
+#include "Validators.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<instruction_set_t> GetInstructionSets() noexcept
+    {
+        std::vector<instruction_set_t> InstructionSets;
+
+        for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            if (::GetInstructionSet() == InstructionSet)
+                InstructionSets.push_back(InstructionSet);
+        }
+
+        return InstructionSets;
+    }
+
+    std::vector<instruction_set_t> InstructionSets; // Filled in by main(), once the validators have detected the processor.
+
+    std::string MappingsDirectory; // The directory with CP932.TXT and JIS0208.TXT, if any.
+
+    size_t Mismatches = 0;
+
+    typedef transcode_result_t (* decoder_t)(const char *, size_t, char16_t *) noexcept;
+
+    const char * GetName(test::system_encoding_t encoding) noexcept
+    {
+        return (encoding == test::system_encoding_t::ShiftJIS) ? "Shift-JIS" : "EUC-JP";
+    }
+
+    decoder_t GetDecoder(test::system_encoding_t encoding) noexcept
+    {
+        return (encoding == test::system_encoding_t::ShiftJIS) ? ::ShiftJISToUTF16 : ::EUCJPToUTF16;
+    }
+
+    /// <summary>
+    /// Decodes the text. Returns false if the decoder rejects it.
+    /// </summary>
+    bool Decode(test::system_encoding_t encoding, const std::string & text, std::u16string & wide) noexcept
+    {
+        wide.assign(GetJapaneseUTF16Capacity(text.size()), u'\0');
+
+        const transcode_result_t Result = GetDecoder(encoding)(text.data(), text.size(), wide.data());
+
+        wide.resize(Result.Written);
+
+        return Result.IsValid();
+    }
+
+    /// <summary>
+    /// Reports the first few mismatches so that a broken decoder does not flood the output.
+    /// </summary>
+    void ReportMismatch(test::system_encoding_t encoding, const std::string & text, const char * reference, const std::u16string & expected, const std::u16string & actual) noexcept
+    {
+        if (++Mismatches > 10)
+            return;
+
+        ::fprintf(stderr, "%s mismatch with %s on", GetName(encoding), reference);
+
+        for (unsigned char c : text)
+            ::fprintf(stderr, " %02X", c);
+
+        ::fprintf(stderr, ": expected");
+
+        for (char16_t c : expected)
+            ::fprintf(stderr, " U+%04X", (unsigned) c);
+
+        ::fprintf(stderr, ", got");
+
+        for (char16_t c : actual)
+            ::fprintf(stderr, " U+%04X", (unsigned) c);
+
+        ::fprintf(stderr, " (%s)\n", ::GetInstructionSetName(::GetInstructionSet()));
+    }
+
+    /// <summary>
+    /// Returns true if the system converter decodes the text in a way the decoders deliberately don't.
+    /// </summary>
+    bool IsSystemSpecific(test::system_encoding_t encoding, const std::string & text) noexcept
+    {
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            const uint8_t c = (uint8_t) text[i];
+
+            if (encoding == test::system_encoding_t::ShiftJIS)
+            {
+                // Windows maps these single bytes to U+0080 and to private code points; the decoder rejects them so that the encoding detection can rule out Shift-JIS.
+                if ((c == 0x80) || (c == 0xA0) || (c >= 0xFD))
+                    return true;
+
+                if (((c >= 0x81) && (c <= 0x9F)) || (c >= 0xE0))
+                    ++i;
+            }
+            else
+            {
+                // JIS X 0212 (SS3) is not supported. iconv passes the other bytes below 0xA1 through as C1 control characters.
+                if ((c >= 0x80) && (c < 0xA1) && (c != 0x8E))
+                    return true;
+
+                if (c >= 0x80)
+                    ++i;
+            }
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Decodes the text with each instruction set and with the system converter, and checks that both accept the same texts and give the same result.
+    /// </summary>
+    void CompareWithSystem(test::system_encoding_t encoding, const std::string & text) noexcept
+    {
+        if (IsSystemSpecific(encoding, text))
+            return;
+
+        std::u16string Expected;
+
+        const bool IsValid = test::SystemToUTF16(encoding, text, Expected);
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::u16string Wide;
+
+            if ((Decode(encoding, text, Wide) != IsValid) || (IsValid && (Wide != Expected)))
+                ReportMismatch(encoding, text, "the system converter", Expected, Wide);
+        }
+    }
+
+    /// <summary>
+    /// Reads a Unicode mapping file. Each line maps the code in the specified column to the code point in the next one. Returns false if the file can't be read.
+    /// </summary>
+    bool ReadMappingFile(const std::string & fileName, size_t column, std::map<uint32_t, char16_t> & mappings)
+    {
+        std::ifstream Stream(MappingsDirectory + "/" + fileName);
+
+        if (!Stream)
+            return false;
+
+        std::string Line;
+
+        while (std::getline(Stream, Line))
+        {
+            if (Line.empty() || (Line[0] == '#'))
+                continue;
+
+            std::istringstream Columns(Line);
+
+            std::vector<uint32_t> Values;
+            std::string Value;
+
+            while ((Values.size() <= column) && (Columns >> Value) && (Value.rfind("0x", 0) == 0))
+                Values.push_back((uint32_t) std::stoul(Value, nullptr, 16));
+
+            if (Values.size() == column + 1)
+                mappings[Values[column - 1]] = (char16_t) Values[column];
+        }
+
+        return true;
+    }
+}
+
+/// <summary>
+/// Checks characters whose mapping differs between code page 932 and JIS X 0208, and the sequences the decoders must reject.
+/// </summary>
+static void KnownCharacters()
+{
+    const struct
+    {
+        test::system_encoding_t Encoding;
+        const char * Text;
+        const char16_t * Expected; // nullptr if the text must be rejected.
+    }
+    Cases[] =
+    {
+        { test::system_encoding_t::ShiftJIS, "\x82\xA0",         u"\x3042" },    // Hiragana A
+        { test::system_encoding_t::ShiftJIS, "\x81\x40",         u"\x3000" },    // Ideographic space
+        { test::system_encoding_t::ShiftJIS, "\x81\x5F",         u"\xFF3C" },    // Fullwidth reverse solidus
+        { test::system_encoding_t::ShiftJIS, "\x81\x60",         u"\xFF5E" },    // Fullwidth tilde, the wave dash of code page 932
+        { test::system_encoding_t::ShiftJIS, "\x87\x40",         u"\x2460" },    // NEC special character: circled digit one
+        { test::system_encoding_t::ShiftJIS, "\xED\x40",         u"\x7E8A" },    // NEC-selected IBM extension
+        { test::system_encoding_t::ShiftJIS, "\xFA\x40",         u"\x2170" },    // IBM extension: small roman numeral one
+        { test::system_encoding_t::ShiftJIS, "\xF0\x40",         u"\xE000" },    // First user-defined character
+        { test::system_encoding_t::ShiftJIS, "\xF9\xFC",         u"\xE757" },    // Last user-defined character
+        { test::system_encoding_t::ShiftJIS, "\xB1",             u"\xFF71" },    // Half-width katakana A
+        { test::system_encoding_t::ShiftJIS, "\x82",             nullptr },      // Truncated
+        { test::system_encoding_t::ShiftJIS, "\x82\x20",         nullptr },      // Not a trail byte
+        { test::system_encoding_t::ShiftJIS, "\x85\x40",         nullptr },      // Empty row
+        { test::system_encoding_t::ShiftJIS, "\x80",             nullptr },
+        { test::system_encoding_t::ShiftJIS, "\xA0",             nullptr },
+        { test::system_encoding_t::ShiftJIS, "\xFD",             nullptr },
+
+        { test::system_encoding_t::EUCJP,    "\xA4\xA2",         u"\x3042" },    // Hiragana A
+        { test::system_encoding_t::EUCJP,    "\xA1\xA1",         u"\x3000" },    // Ideographic space
+        { test::system_encoding_t::EUCJP,    "\xA1\xC1",         u"\x301C" },    // Wave dash
+        { test::system_encoding_t::EUCJP,    "\xA1\xC2",         u"\x2016" },    // Double vertical line
+        { test::system_encoding_t::EUCJP,    "\xA1\xDD",         u"\x2212" },    // Minus sign
+        { test::system_encoding_t::EUCJP,    "\xA2\xCC",         u"\x00AC" },    // Not sign
+        { test::system_encoding_t::EUCJP,    "\x8E\xB1",         u"\xFF71" },    // Half-width katakana A
+        { test::system_encoding_t::EUCJP,    "\xAD\xA1",         nullptr },      // NEC special characters are not part of JIS X 0208
+        { test::system_encoding_t::EUCJP,    "\x8F\xB0\xA1",     nullptr },      // JIS X 0212
+        { test::system_encoding_t::EUCJP,    "\xA4",             nullptr },      // Truncated
+        { test::system_encoding_t::EUCJP,    "\x8E\xE0",         nullptr },      // Not a half-width katakana
+    };
+
+    for (const auto & Case : Cases)
+    {
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::u16string Wide;
+
+            const bool IsValid = Decode(Case.Encoding, Case.Text, Wide);
+
+            CHECK(IsValid == (Case.Expected != nullptr));
+
+            if (IsValid && (Case.Expected != nullptr))
+                CHECK(Wide == Case.Expected);
+        }
+    }
+}
+
+/// <summary>
+/// Decodes every single byte and every pair of bytes and compares the result with the system converter.
+/// </summary>
+static void AllSequences()
+{
+    Mismatches = 0;
+
+    for (auto Encoding : { test::system_encoding_t::ShiftJIS, test::system_encoding_t::EUCJP })
+    {
+        for (uint32_t i = 0; i < 0x100; ++i)
+            CompareWithSystem(Encoding, std::string(1, (char) i));
+
+        for (uint32_t i = 0x8000; i < 0x10000; ++i)
+            CompareWithSystem(Encoding, { (char) (i >> 8), (char) (i & 0xFF) });
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Decodes every character, encodes it again with the system converter and checks that decoding the result gives the same character.
+/// </summary>
+static void RoundTrips()
+{
+    Mismatches = 0;
+
+    for (auto Encoding : { test::system_encoding_t::ShiftJIS, test::system_encoding_t::EUCJP })
+    {
+        for (uint32_t i = 0x8000; i < 0x10000; ++i)
+        {
+            const std::string Text = { (char) (i >> 8), (char) (i & 0xFF) };
+
+            std::u16string Wide;
+
+            if (!Decode(Encoding, Text, Wide))
+                continue;
+
+            std::string Encoded;
+            std::u16string Decoded;
+
+            if (!test::SystemFromUTF16(Encoding, Wide, Encoded) || !Decode(Encoding, Encoded, Decoded) || (Decoded != Wide))
+                ReportMismatch(Encoding, Text, "the round trip", Wide, Decoded);
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Compares the decoders with the Unicode mapping files CP932.TXT and JIS0208.TXT. Every code in a file must decode to its code point; every other code must be rejected.
+/// </summary>
+static void MappingFiles()
+{
+    Mismatches = 0;
+
+    ::SetInstructionSet(instruction_set_t::Scalar);
+
+    // CP932.TXT: the code page 932 code in the first column, the code point in the second. The user-defined area is not listed.
+    {
+        std::map<uint32_t, char16_t> Mappings;
+
+        const bool IsRead = ReadMappingFile("CP932.TXT", 1, Mappings);
+
+        CHECK(IsRead);
+
+        if (!IsRead)
+            return;
+
+        for (uint32_t i = 0; i < 0x10000; ++i)
+        {
+            const uint32_t Lead = i >> 8;
+            const uint32_t Trail = i & 0xFF;
+
+            if ((i >= 0x100) && ((Lead < 0x81) || (Trail < 0x40)))
+                continue;
+
+            const std::string Text = (i < 0x100) ? std::string(1, (char) Trail) : std::string({ (char) Lead, (char) Trail });
+
+            if ((Lead >= 0xF0) && (Lead <= 0xF9) && (Trail != 0x7F) && (Trail <= 0xFC))
+                continue;
+
+            std::u16string Wide;
+
+            const bool IsValid = Decode(test::system_encoding_t::ShiftJIS, Text, Wide);
+
+            const auto Mapping = Mappings.find(i);
+
+            if (Mapping == Mappings.end())
+            {
+                if (IsValid && (Wide.size() == 1))
+                    ReportMismatch(test::system_encoding_t::ShiftJIS, Text, "CP932.TXT", { }, Wide);
+            }
+            else
+            {
+                if (!IsValid || (Wide != std::u16string(1, Mapping->second)))
+                    ReportMismatch(test::system_encoding_t::ShiftJIS, Text, "CP932.TXT", std::u16string(1, Mapping->second), Wide);
+            }
+        }
+    }
+
+    // JIS0208.TXT: the Shift-JIS code in the first column, the JIS X 0208 code in the second and the code point in the third.
+    {
+        std::map<uint32_t, char16_t> Mappings;
+
+        const bool IsRead = ReadMappingFile("JIS0208.TXT", 2, Mappings);
+
+        CHECK(IsRead);
+
+        if (!IsRead)
+            return;
+
+        for (uint32_t Row = 0x21; Row <= 0x7E; ++Row)
+        {
+            for (uint32_t Cell = 0x21; Cell <= 0x7E; ++Cell)
+            {
+                const std::string Text = { (char) (Row | 0x80), (char) (Cell | 0x80) };
+
+                std::u16string Wide;
+
+                const bool IsValid = Decode(test::system_encoding_t::EUCJP, Text, Wide);
+
+                auto Mapping = Mappings.find((Row << 8) | Cell);
+
+                // JIS0208.TXT maps 0x2140 to U+005C, which would decode to a backslash. Like code page 932 and iconv, the decoder uses U+FF3C.
+                if ((Mapping != Mappings.end()) && (Mapping->first == 0x2140))
+                    Mapping->second = 0xFF3C;
+
+                if (Mapping == Mappings.end())
+                {
+                    if (IsValid)
+                        ReportMismatch(test::system_encoding_t::EUCJP, Text, "JIS0208.TXT", { }, Wide);
+                }
+                else
+                {
+                    if (!IsValid || (Wide != std::u16string(1, Mapping->second)))
+                        ReportMismatch(test::system_encoding_t::EUCJP, Text, "JIS0208.TXT", std::u16string(1, Mapping->second), Wide);
+                }
+            }
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Decodes random texts with runs of ASCII of various lengths, so that the vectorized ASCII path starts and stops at every offset.
+/// </summary>
+static void RandomTexts()
+{
+    Mismatches = 0;
+
+    std::mt19937 Random(20261017);
+
+    static const char * const ShiftJIS[] = { "\x82\xA0", "\x83\x41", "\x88\x9F", "\xB1", "\x81\x60", "\x87\x40", "\xFA\x40" };
+    static const char * const EUCJP[] = { "\xA4\xA2", "\xA5\xA2", "\xB0\xA1", "\x8E\xB1", "\xA1\xC1" };
+
+    for (auto Encoding : { test::system_encoding_t::ShiftJIS, test::system_encoding_t::EUCJP })
+    {
+        for (int i = 0; i < 10000; ++i)
+        {
+            std::string Text;
+
+            const size_t Runs = Random() % 8;
+
+            for (size_t j = 0; j < Runs; ++j)
+            {
+                const size_t Length = Random() % 40;
+
+                for (size_t k = 0; k < Length; ++k)
+                    Text.push_back((char) (0x20 + Random() % 0x5F));
+
+                Text.append((Encoding == test::system_encoding_t::ShiftJIS) ? ShiftJIS[Random() % std::size(ShiftJIS)] : EUCJP[Random() % std::size(EUCJP)]);
+            }
+
+            CompareWithSystem(Encoding, Text);
+
+            // Break the text with a lead byte that is not followed by a trail byte.
+            if (!Text.empty())
+            {
+                Text.insert(Text.begin() + (Random() % Text.size()), (char) ((Encoding == test::system_encoding_t::ShiftJIS) ? 0x82 : 0xA4));
+
+                CompareWithSystem(Encoding, Text);
+            }
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// "--mappings <directory>" only compares the decoders with the Unicode mapping files CP932.TXT and JIS0208.TXT in the directory.
+/// The test is reported as skipped if the directory is empty and fails if the files can't be read.
+/// </summary>
+int main(int argc, char * argv[])
+{
+    InstructionSets = GetInstructionSets();
+
+    if ((argc > 1) && (::strcmp(argv[1], "--mappings") == 0))
+    {
+        if ((argc < 3) || (*argv[2] == '\0'))
+        {
+            ::printf("No mappings directory specified. CP932.TXT and JIS0208.TXT are not checked.\n");
+
+            return test::SkipExitCode;
+        }
+
+        MappingsDirectory = argv[2];
+
+        RUN(MappingFiles);
+
+        return test::GetExitCode();
+    }
+
+    RUN(KnownCharacters);
+    RUN(AllSequences);
+    RUN(RoundTrips);
+    RUN(RandomTexts);
+
+    return test::GetExitCode();
+}
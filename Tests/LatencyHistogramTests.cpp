@@ -0,0 +1,171 @@
+
+/** $VER: LatencyHistogramTests.cpp (2026.10.17) P. Stuer - Tests the buckets and the percentiles of the latency histogram. **/
+
+#include "Test.h"
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// <summary>
+    /// Gets the percentile of the sorted values the way the histogram defines it: the value at the rank ceil(percentile * count), 1-based.
+    /// </summary>
+    uint64_t GetPercentile(const std::vector<uint64_t> & sortedValues, double percentile)
+    {
+        const size_t Rank = (std::max)((size_t) std::ceil(percentile / 100. * (double) sortedValues.size()), (size_t) 1);
+
+        return sortedValues[Rank - 1];
+    }
+
+    /// <summary>
+    /// Records the values and compares the percentiles with those of the sorted values. The histogram may only round up, by less than the width of a bucket.
+    /// </summary>
+    bool IsAccurate(std::vector<uint64_t> values)
+    {
+        latency_histogram_t Histogram;
+
+        for (uint64_t Value : values)
+            Histogram.Record(Value);
+
+        std::sort(values.begin(), values.end());
+
+        for (double Percentile : { 50., 90., 99., 100. })
+        {
+            const uint64_t Expected = GetPercentile(values, Percentile);
+            const uint64_t Actual = Histogram.GetPercentile(Percentile);
+
+            if (Actual != (std::min)(latency_histogram_t::GetUpperBound(latency_histogram_t::GetIndex(Expected)), values.back()))
+                return false;
+
+            if ((Actual < Expected) || ((double) (Actual - Expected) > (double) Expected / 16.))
+                return false;
+        }
+
+        return (Histogram.GetCount() == values.size()) && (Histogram.GetMin() == values.front()) && (Histogram.GetMax() == values.back());
+    }
+}
+
+/// <summary>
+/// Values below 16 have a bucket of their own; from 16 on, each power of 2 is divided in 16 buckets.
+/// </summary>
+static void BucketBoundaries()
+{
+    CHECK(latency_histogram_t::GetIndex(0) == 0);
+    CHECK(latency_histogram_t::GetIndex(15) == 15);
+    CHECK(latency_histogram_t::GetIndex(16) == 16);
+    CHECK(latency_histogram_t::GetIndex(31) == 31);
+    CHECK(latency_histogram_t::GetIndex(32) == 32);
+    CHECK(latency_histogram_t::GetIndex(33) == 32);
+    CHECK(latency_histogram_t::GetIndex(34) == 33);
+    CHECK(latency_histogram_t::GetIndex(0xFFFFFFFFull) == latency_histogram_t::BucketCount - 1);
+
+    CHECK(latency_histogram_t::GetUpperBound(15) == 15);
+    CHECK(latency_histogram_t::GetUpperBound(16) == 16);
+    CHECK(latency_histogram_t::GetUpperBound(31) == 31);
+    CHECK(latency_histogram_t::GetUpperBound(32) == 33);
+    CHECK(latency_histogram_t::GetUpperBound(latency_histogram_t::BucketCount - 1) == 0xFFFFFFFFull);
+
+    // Every value belongs to the bucket whose upper bound is the first one at or above it.
+    bool IsConsistent = true;
+
+    for (size_t i = 1; i < latency_histogram_t::BucketCount; ++i)
+    {
+        const uint64_t First = latency_histogram_t::GetUpperBound(i - 1) + 1;
+        const uint64_t Last = latency_histogram_t::GetUpperBound(i);
+
+        IsConsistent &= (First <= Last) && (latency_histogram_t::GetIndex(First) == i) && (latency_histogram_t::GetIndex(Last) == i);
+    }
+
+    CHECK(IsConsistent);
+}
+
+/// <summary>
+/// Values above the largest bucket are recorded as the largest value.
+/// </summary>
+static void LargeValuesAreClamped()
+{
+    latency_histogram_t Histogram;
+
+    Histogram.Record(1ull << 40);
+    Histogram.Record(~0ull);
+
+    CHECK(Histogram.GetCount() == 2);
+    CHECK(Histogram.GetMin() == latency_histogram_t::MaxValue);
+    CHECK(Histogram.GetMax() == latency_histogram_t::MaxValue);
+    CHECK(Histogram.GetPercentile(50.) == latency_histogram_t::MaxValue);
+    CHECK(Histogram.GetMean() == (double) latency_histogram_t::MaxValue);
+}
+
+/// <summary>
+/// An empty histogram reports zeros; a single value is reported exactly.
+/// </summary>
+static void EmptyAndSingleValue()
+{
+    latency_histogram_t Histogram;
+
+    CHECK(Histogram.GetPercentile(50.) == 0);
+    CHECK(Histogram.GetMean() == 0.);
+
+    Histogram.Record(1000);
+
+    CHECK(Histogram.GetPercentile(0.) == 1000);
+    CHECK(Histogram.GetPercentile(50.) == 1000);
+    CHECK(Histogram.GetPercentile(99.) == 1000);
+}
+
+/// <summary>
+/// Compares p50, p90, p99 and the maximum with a sorted reference on uniform and long-tailed distributions.
+/// </summary>
+static void PercentilesMatchSortedReference()
+{
+    std::mt19937_64 Random(20261017);
+
+    std::vector<uint64_t> Values;
+
+    // Small values only: every value has a bucket of its own.
+    for (int i = 0; i < 1000; ++i)
+        Values.push_back(Random() % 16);
+
+    CHECK(IsAccurate(Values));
+
+    // Uniform, like the duration of a host call.
+    Values.clear();
+
+    for (int i = 0; i < 10000; ++i)
+        Values.push_back(100 + Random() % 900);
+
+    CHECK(IsAccurate(Values));
+
+    // Log-uniform from 1 us to 10 s, like the latency of an event behind a slow page.
+    Values.clear();
+
+    std::uniform_real_distribution<double> Exponent(0., 7.);
+
+    for (int i = 0; i < 10000; ++i)
+        Values.push_back((uint64_t) std::pow(10., Exponent(Random)));
+
+    CHECK(IsAccurate(Values));
+
+    // Mostly fast with a few outliers, so that p99 falls in the tail.
+    Values.clear();
+
+    for (int i = 0; i < 10000; ++i)
+        Values.push_back((i % 100 == 0) ? 50000 + Random() % 50000 : 200 + Random() % 100);
+
+    CHECK(IsAccurate(Values));
+}
+
+int main()
+{
+    RUN(BucketBoundaries);
+    RUN(LargeValuesAreClamped);
+    RUN(EmptyAndSingleValue);
+    RUN(PercentilesMatchSortedReference);
+
+    return test::GetExitCode();
+}
@@ -0,0 +1,195 @@
+
+/** $VER: MojibakeTests.cpp (2026.10.17) P. Stuer - Tests the repair of Japanese texts that were decoded as Latin-1 or Windows-1252. **/
+
+#include "Test.h"
+
+#include "Mojibake.h"
+#include "Validators.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<instruction_set_t> GetInstructionSets() noexcept
+    {
+        std::vector<instruction_set_t> InstructionSets;
+
+        for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            if (::GetInstructionSet() == InstructionSet)
+                InstructionSets.push_back(InstructionSet);
+        }
+
+        return InstructionSets;
+    }
+
+    std::vector<instruction_set_t> InstructionSets; // Filled in by main(), once the validators have detected the processor.
+
+    /// <summary>
+    /// The Shift-JIS MIDI title of the Data1 test case in Encoding.cpp.
+    /// </summary>
+    const char Data1[] =
+        "Final Fantasy 5 [ \x83\x72\x83\x62\x83\x4f\x83\x75\x83\x8a\x83\x62\x83\x61\x82\xcc\x8e\x80\x93\xac \x81\x66\x82\x58\x82\x58 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// The Text1 test case in Encoding.cpp, in UTF-8.
+    /// </summary>
+    const char Text1[] = "Final Fantasy 5 [ \xE3\x83\x93\xE3\x83\x83\xE3\x82\xB0\xE3\x83\x96\xE3\x83\xAA\xE3\x83\x83\xE3\x83\x82\xE3\x81\xAE\xE6\xAD\xBB\xE9\x97\x98 \xE2\x80\x99\xEF\xBC\x99\xEF\xBC\x99 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// "ドラゴンクエスト 序曲のマーチ" in Shift-JIS and in UTF-8.
+    /// </summary>
+    const char ShiftJISTitle[] = "\x83\x68\x83\x89\x83\x53\x83\x93\x83\x4E\x83\x47\x83\x58\x83\x67 \x8F\x98\x8B\xC8\x82\xCC\x83\x7D\x81\x5B\x83\x60";
+    const char ShiftJISText[] = "\xE3\x83\x89\xE3\x83\xA9\xE3\x82\xB4\xE3\x83\xB3\xE3\x82\xAF\xE3\x82\xA8\xE3\x82\xB9\xE3\x83\x88 \xE5\xBA\x8F\xE6\x9B\xB2\xE3\x81\xAE\xE3\x83\x9E\xE3\x83\xBC\xE3\x83\x81";
+
+    /// <summary>
+    /// "ファイナルファンタジー メインテーマ" in EUC-JP and in UTF-8.
+    /// </summary>
+    const char EUCJPTitle[] = "\xA5\xD5\xA5\xA1\xA5\xA4\xA5\xCA\xA5\xEB\xA5\xD5\xA5\xA1\xA5\xF3\xA5\xBF\xA5\xB8\xA1\xBC \xA5\xE1\xA5\xA4\xA5\xF3\xA5\xC6\xA1\xBC\xA5\xDE";
+    const char EUCJPText[] = "\xE3\x83\x95\xE3\x82\xA1\xE3\x82\xA4\xE3\x83\x8A\xE3\x83\xAB\xE3\x83\x95\xE3\x82\xA1\xE3\x83\xB3\xE3\x82\xBF\xE3\x82\xB8\xE3\x83\xBC \xE3\x83\xA1\xE3\x82\xA4\xE3\x83\xB3\xE3\x83\x86\xE3\x83\xBC\xE3\x83\x9E";
+
+    /// <summary>
+    /// The characters of Windows-1252 for the bytes 0x80 to 0x9F. The undefined bytes map to the C1 control with the same value.
+    /// </summary>
+    const char16_t Windows1252[32] =
+    {
+        0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+        0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+        0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+        0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+    };
+
+    void AppendUTF8(std::string & text, uint32_t c)
+    {
+        if (c < 0x80)
+            text.push_back((char) c);
+        else
+        if (c < 0x800)
+        {
+            text.push_back((char) (0xC0 | (c >> 6)));
+            text.push_back((char) (0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            text.push_back((char) (0xE0 | (c >> 12)));
+            text.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            text.push_back((char) (0x80 | (c & 0x3F)));
+        }
+    }
+
+    /// <summary>
+    /// Decodes the bytes as Latin-1 or Windows-1252 and returns the result in UTF-8, the way a tagger that didn't know the encoding stored them.
+    /// </summary>
+    std::string Misdecode(const char * bytes, bool isWindows1252)
+    {
+        std::string Text;
+
+        for (const char * p = bytes; *p != '\0'; ++p)
+        {
+            const uint8_t c = (uint8_t) *p;
+
+            AppendUTF8(Text, (isWindows1252 && (c >= 0x80) && (c < 0xA0)) ? Windows1252[c - 0x80] : c);
+        }
+
+        return Text;
+    }
+
+    /// <summary>
+    /// Returns true if the text is repaired to the expected text with every instruction set.
+    /// </summary>
+    bool IsRepaired(const std::string & text, const char * expected)
+    {
+        mojibake_repairer_t Repairer;
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::string RepairedText;
+
+            if (!Repairer.Repair(text.data(), text.size(), RepairedText) || (RepairedText != expected))
+                return false;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Returns true if the text is left untouched with every instruction set.
+    /// </summary>
+    bool IsUntouched(const std::string & text)
+    {
+        mojibake_repairer_t Repairer;
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::string RepairedText = "Untouched";
+
+            if (Repairer.Repair(text.data(), text.size(), RepairedText) || (RepairedText != "Untouched"))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+/// <summary>
+/// Repairs the Shift-JIS test case of Encoding.cpp after it was decoded as Latin-1 and as Windows-1252.
+/// </summary>
+static void Data1Test()
+{
+    CHECK(IsRepaired(Misdecode(Data1, false), Text1));
+    CHECK(IsRepaired(Misdecode(Data1, true), Text1));
+}
+
+/// <summary>
+/// Repairs titles in Shift-JIS and in EUC-JP.
+/// </summary>
+static void JapaneseTitles()
+{
+    CHECK(IsRepaired(Misdecode(ShiftJISTitle, false), ShiftJISText));
+    CHECK(IsRepaired(Misdecode(ShiftJISTitle, true), ShiftJISText));
+    CHECK(IsRepaired(Misdecode(EUCJPTitle, false), EUCJPText));
+    CHECK(IsRepaired(Misdecode(EUCJPTitle, true), EUCJPText));
+}
+
+/// <summary>
+/// Leaves real Latin text alone, including the texts that have the byte image of a mis-decoded UTF-8 text.
+/// </summary>
+static void LatinTexts()
+{
+    CHECK(IsUntouched("Caf\xC3\xA9 del Mar"));                                      // Café del Mar
+    CHECK(IsUntouched("Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9" "e"));                     // Crème brûlée
+    CHECK(IsUntouched("Bj\xC3\xB6rk - J\xC3\xB3ga"));                               // Björk - Jóga
+    CHECK(IsUntouched("\xE2\x80\x9CSe\xC3\xB1or\xE2\x80\x9D \xE2\x80\x93 Live"));   // “Señor” – Live
+    CHECK(IsUntouched("\xC3\x83\xC2\xA9"));                                         // Ã©, the UTF-8 of é read as Latin-1
+    CHECK(IsUntouched("Price: \xC3\x82\xC2\xA3" "5"));                              // Â£5, the UTF-8 of £ read as Latin-1
+    CHECK(IsUntouched(Text1));                                                      // Japanese text that was decoded correctly.
+}
+
+/// <summary>
+/// Leaves texts that contain only ASCII alone.
+/// </summary>
+static void ASCIITexts()
+{
+    CHECK(IsUntouched(""));
+    CHECK(IsUntouched("Final Fantasy 5 - Battle at the Big Bridge"));
+    CHECK(IsUntouched(std::string(1000, 'A')));
+}
+
+int main()
+{
+    InstructionSets = GetInstructionSets();
+
+    RUN(Data1Test);
+    RUN(JapaneseTitles);
+    RUN(LatinTexts);
+    RUN(ASCIITexts);
+
+    return test::GetExitCode();
+}
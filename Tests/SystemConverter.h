@@ -0,0 +1,144 @@
+
+/** $VER: SystemConverter.h (2026.10.17) P. Stuer - Converts text with the converters of the operating system, as a reference for the tests and benchmarks. **/
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <iconv.h>
+#endif
+
+namespace test
+{
+    /// <summary>
+    /// Identifies an encoding supported by the system converter.
+    /// </summary>
+    enum class system_encoding_t
+    {
+        UTF8,
+        ShiftJIS,   // Code page 932
+        EUCJP,
+    };
+
+#ifdef _WIN32
+    inline UINT GetCodePage(system_encoding_t encoding) noexcept
+    {
+        switch (encoding)
+        {
+            case system_encoding_t::UTF8:       return CP_UTF8;
+            case system_encoding_t::ShiftJIS:   return 932;
+            case system_encoding_t::EUCJP:      return 20932;
+            default:                            return 0;
+        }
+    }
+#else
+    inline const char * GetCharsetName(system_encoding_t encoding) noexcept
+    {
+        switch (encoding)
+        {
+            case system_encoding_t::UTF8:       return "UTF-8";
+            case system_encoding_t::ShiftJIS:   return "CP932";
+            case system_encoding_t::EUCJP:      return "EUC-JP";
+            default:                            return "";
+        }
+    }
+
+    /// <summary>
+    /// Converts a byte sequence with iconv. Returns false if iconv rejects the input, including input that ends in the middle of a character.
+    /// </summary>
+    inline bool Convert(const char * to, const char * from, const void * src, size_t size, std::string & dst) noexcept
+    {
+        iconv_t Converter = ::iconv_open(to, from);
+
+        if (Converter == (iconv_t) -1)
+            return false;
+
+        dst.resize(size * 4 + 16);
+
+        char * In = (char *) src;
+        size_t InSize = size;
+        char * Out = dst.data();
+        size_t OutSize = dst.size();
+
+        const size_t Result = ::iconv(Converter, &In, &InSize, &Out, &OutSize);
+
+        ::iconv_close(Converter);
+
+        if ((Result == (size_t) -1) || (InSize != 0))
+            return false;
+
+        dst.resize(dst.size() - OutSize);
+
+        return true;
+    }
+#endif
+
+    /// <summary>
+    /// Converts the text to UTF-16 the way the operating system does. Returns false if the text is not valid in the specified encoding.
+    /// </summary>
+    inline bool SystemToUTF16(system_encoding_t encoding, const std::string & text, std::u16string & wide) noexcept
+    {
+        wide.clear();
+
+        if (text.empty())
+            return true;
+
+#ifdef _WIN32
+        const int Size = ::MultiByteToWideChar(GetCodePage(encoding), MB_ERR_INVALID_CHARS, text.data(), (int) text.size(), nullptr, 0);
+
+        if (Size == 0)
+            return false;
+
+        wide.resize((size_t) Size);
+
+        ::MultiByteToWideChar(GetCodePage(encoding), MB_ERR_INVALID_CHARS, text.data(), (int) text.size(), (wchar_t *) wide.data(), Size);
+#else
+        std::string Bytes;
+
+        if (!Convert("UTF-16LE", GetCharsetName(encoding), text.data(), text.size(), Bytes))
+            return false;
+
+        wide.resize(Bytes.size() / 2);
+
+        ::memcpy(wide.data(), Bytes.data(), wide.size() * 2);
+#endif
+
+        return true;
+    }
+
+    /// <summary>
+    /// Converts UTF-16 to the specified encoding the way the operating system does. Returns false if the text contains an unpaired surrogate or a character without a mapping.
+    /// </summary>
+    inline bool SystemFromUTF16(system_encoding_t encoding, const std::u16string & wide, std::string & text) noexcept
+    {
+        text.clear();
+
+        if (wide.empty())
+            return true;
+
+#ifdef _WIN32
+        const DWORD Flags = (encoding == system_encoding_t::UTF8) ? WC_ERR_INVALID_CHARS : WC_NO_BEST_FIT_CHARS;
+
+        BOOL IsDefaultCharUsed = FALSE;
+
+        const int Size = ::WideCharToMultiByte(GetCodePage(encoding), Flags, (const wchar_t *) wide.data(), (int) wide.size(), nullptr, 0, nullptr, (encoding == system_encoding_t::UTF8) ? nullptr : &IsDefaultCharUsed);
+
+        if ((Size == 0) || IsDefaultCharUsed)
+            return false;
+
+        text.resize((size_t) Size);
+
+        ::WideCharToMultiByte(GetCodePage(encoding), Flags, (const wchar_t *) wide.data(), (int) wide.size(), text.data(), Size, nullptr, nullptr);
+
+        return true;
+#else
+        return Convert(GetCharsetName(encoding), "UTF-16LE", wide.data(), wide.size() * 2, text);
+#endif
+    }
+}
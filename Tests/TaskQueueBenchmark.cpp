@@ -0,0 +1,226 @@
+
+/** $VER: TaskQueueBenchmark.cpp (2026.10.17) P. Stuer - Compares the task queue with a heap-allocated task and a message per call. **/
+
+#include "TaskQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<uint64_t> Allocations(0);
+}
+
+// Counts the allocations of the whole program.
+void * operator new(size_t size)
+{
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void * p = std::malloc(size ? size : 1);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, size_t) noexcept { std::free(p); }
+
+namespace
+{
+    /// <summary>
+    /// Stands in for the message queue of the window: PostMessage() appends a message under a lock, the window thread takes them out one by one.
+    /// </summary>
+    class message_queue_t
+    {
+    public:
+        void Post(void * message)
+        {
+            std::lock_guard<std::mutex> Lock(_Lock);
+
+            _Messages.push_back(message);
+        }
+
+        bool Get(void *& message)
+        {
+            std::lock_guard<std::mutex> Lock(_Lock);
+
+            if (_Messages.empty())
+                return false;
+
+            message = _Messages.front();
+            _Messages.pop_front();
+
+            return true;
+        }
+
+    private:
+        std::mutex _Lock;
+        std::deque<void *> _Messages;
+    };
+
+    struct result_t
+    {
+        double PostsPerSecond;
+        double AllocationsPerPost;
+        double OverflowsPerPost;
+    };
+
+    const int BurstSize = 16;
+
+    /// <summary>
+    /// The previous RunAsync(): every task is copied into a std::function on the heap and gets a message of its own.
+    /// </summary>
+    class heap_tasks_t
+    {
+    public:
+        void Push(std::atomic<uint64_t> & runs, int i)
+        {
+            _Messages.Post(new std::function<void()>([&runs, i] { runs.fetch_add((uint64_t) (i >= 0), std::memory_order_relaxed); }));
+        }
+
+        void ProcessMessages()
+        {
+            void * Message;
+
+            while (_Messages.Get(Message))
+            {
+                auto * Task = (std::function<void()> *) Message;
+
+                (*Task)();
+
+                delete Task;
+            }
+        }
+
+        uint64_t GetOverflows() const noexcept { return 0; }
+
+    private:
+        message_queue_t _Messages;
+    };
+
+    /// <summary>
+    /// The current RunAsync(): tasks are pushed into the task queue and a message is only posted when no wakeup is pending.
+    /// </summary>
+    class queued_tasks_t
+    {
+    public:
+        void Push(std::atomic<uint64_t> & runs, int i)
+        {
+            _Queue.Push([&runs, i] { runs.fetch_add((uint64_t) (i >= 0), std::memory_order_relaxed); });
+
+            if (_Queue.RequestWakeup())
+                _Messages.Post(nullptr);
+        }
+
+        void ProcessMessages()
+        {
+            void * Message;
+
+            while (_Messages.Get(Message))
+                _Queue.Drain();
+        }
+
+        uint64_t GetOverflows() const noexcept { return _Queue.GetOverflows(); }
+
+    private:
+        message_queue_t _Messages;
+        task_queue_t _Queue;
+    };
+
+    /// <summary>
+    /// Pushes the tasks from the specified number of producer threads while the calling thread processes the messages.
+    /// With 0 producers the calling thread pushes bursts of tasks and processes the messages after each burst, like a template calling the host object.
+    /// </summary>
+    template<typename T>
+    result_t Run(int producerCount, int taskCount)
+    {
+        T Method;
+
+        std::atomic<uint64_t> Runs(0);
+        std::atomic<int> Finished(0);
+
+        const uint64_t AllocationsBefore = Allocations.load();
+        const auto Start = std::chrono::steady_clock::now();
+
+        if (producerCount == 0)
+        {
+            for (int i = 0; i < taskCount; ++i)
+            {
+                Method.Push(Runs, i);
+
+                if ((i + 1) % BurstSize == 0)
+                    Method.ProcessMessages();
+            }
+
+            Method.ProcessMessages();
+        }
+        else
+        {
+            std::vector<std::thread> Producers;
+
+            for (int p = 0; p < producerCount; ++p)
+            {
+                Producers.emplace_back([&]
+                {
+                    for (int i = 0; i < taskCount; ++i)
+                        Method.Push(Runs, i);
+
+                    ++Finished;
+                });
+            }
+
+            for (;;)
+            {
+                const bool IsFinished = (Finished.load() == producerCount);
+
+                Method.ProcessMessages();
+
+                if (IsFinished)
+                    break;
+            }
+
+            for (auto & Producer : Producers)
+                Producer.join();
+        }
+
+        const auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+        const double Posts = (double) (std::max)(producerCount, 1) * taskCount;
+
+        if ((double) Runs.load() != Posts)
+            ::fprintf(stderr, "%.0f tasks were pushed but %llu ran.\n", Posts, (unsigned long long) Runs.load());
+
+        // The thread objects and the producer lambdas account for a few allocations that are not per post.
+        return { Posts / Elapsed, (double) (Allocations.load() - AllocationsBefore) / Posts, (double) Method.GetOverflows() / Posts };
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const int TaskCount = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+
+    ::printf("%-24s %9s %14s %18s %16s\n", "Method", "Producers", "Posts/s", "Allocations/post", "Overflows/post");
+
+    // 0 producers: bursts of 16 tasks on the window thread. 1 and 4 producers: other threads flood the window thread.
+    for (int ProducerCount : { 0, 1, 4 })
+    {
+        const result_t Heap = Run<heap_tasks_t>(ProducerCount, TaskCount);
+        const result_t Queued = Run<queued_tasks_t>(ProducerCount, TaskCount);
+
+        ::printf("%-24s %9d %14.0f %18.3f %16s\n",   "std::function + message", ProducerCount, Heap.PostsPerSecond, Heap.AllocationsPerPost, "-");
+        ::printf("%-24s %9d %14.0f %18.3f %16.3f\n", "task_queue_t", ProducerCount, Queued.PostsPerSecond, Queued.AllocationsPerPost, Queued.OverflowsPerPost);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+
+/** $VER: TaskQueueTests.cpp (2026.10.17) P. Stuer - Tests the order in which the task queue runs its tasks. **/
+
+#include "Test.h"
+
+#include "TaskQueue.h"
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /// <summary>
+    /// Tasks run in the order they were pushed, including the ones that did not fit in the ring.
+    /// </summary>
+    void OverflowKeepsOrder()
+    {
+        task_queue_t Queue;
+
+        std::vector<int> Order;
+
+        for (int i = 0; i < (int) task_queue_t::Capacity * 3; ++i)
+            Queue.Push([&Order, i] { Order.push_back(i); });
+
+        CHECK(Queue.GetOverflows() == task_queue_t::Capacity * 2);
+
+        const size_t Count = Queue.Drain();
+
+        CHECK(Count == task_queue_t::Capacity * 3);
+        CHECK(Order.size() == task_queue_t::Capacity * 3);
+
+        for (size_t i = 0; i < Order.size(); ++i)
+            CHECK(Order[i] == (int) i);
+
+        // The ring is used again once the overflow list has been emptied.
+        Queue.Push([&Order] { Order.push_back(-1); });
+
+        CHECK(Queue.GetOverflows() == task_queue_t::Capacity * 2);
+        CHECK(Queue.Drain() == 1);
+        CHECK(Order.back() == -1);
+    }
+
+    /// <summary>
+    /// A task that is too large for a slot still runs in order.
+    /// </summary>
+    void LargeTasksKeepOrder()
+    {
+        task_queue_t Queue;
+
+        std::vector<int> Order;
+        std::array<char, 256> Padding = { };
+
+        Queue.Push([&Order] { Order.push_back(0); });
+        Queue.Push([&Order, Padding] { Order.push_back(1 + Padding[0]); });
+        Queue.Push([&Order] { Order.push_back(2); });
+
+        Queue.Drain();
+
+        CHECK((Order == std::vector<int>{ 0, 1, 2 }));
+    }
+
+    /// <summary>
+    /// Cleared tasks are destroyed without running.
+    /// </summary>
+    void ClearDiscardsTasks()
+    {
+        task_queue_t Queue;
+
+        int Runs = 0;
+
+        for (size_t i = 0; i < task_queue_t::Capacity + 10; ++i)
+            Queue.Push([&Runs] { ++Runs; });
+
+        Queue.Clear();
+
+        CHECK(Queue.Drain() == 0);
+        CHECK(Runs == 0);
+    }
+
+    /// <summary>
+    /// The tasks of each producer run in the order that producer pushed them while the consumer drains concurrently and the ring overflows.
+    /// </summary>
+    void ProducersKeepOrder()
+    {
+        const int ProducerCount = 4;
+        const int TaskCount = 100000;
+
+        task_queue_t Queue;
+
+        std::array<int, ProducerCount> Last;
+        std::atomic<int> Finished(0);
+
+        Last.fill(-1);
+
+        bool IsOrdered = true;
+        int Runs = 0;
+
+        std::vector<std::thread> Producers;
+
+        for (int p = 0; p < ProducerCount; ++p)
+        {
+            Producers.emplace_back([&, p]
+            {
+                for (int i = 0; i < TaskCount; ++i)
+                {
+                    Queue.Push([&, p, i]
+                    {
+                        if (Last[p] + 1 != i)
+                            IsOrdered = false;
+
+                        Last[p] = i;
+                        ++Runs;
+                    });
+
+                    (void) Queue.RequestWakeup();
+                }
+
+                ++Finished;
+            });
+        }
+
+        while (Finished.load() != ProducerCount)
+            Queue.Drain();
+
+        for (auto & Producer : Producers)
+            Producer.join();
+
+        Queue.Drain();
+
+        CHECK(IsOrdered);
+        CHECK(Runs == ProducerCount * TaskCount);
+        CHECK(Queue.GetTasksQueued() == (uint64_t) ProducerCount * TaskCount);
+    }
+}
+
+int main()
+{
+    RUN(OverflowKeepsOrder);
+    RUN(LargeTasksKeepOrder);
+    RUN(ClearDiscardsTasks);
+    RUN(ProducersKeepOrder);
+
+    return test::GetExitCode();
+}
@@ -0,0 +1,58 @@
+
+/** $VER: Test.h (2026.10.17) P. Stuer - Minimal test support for the portable parts of the component. **/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace test
+{
+    inline int & GetFailures() noexcept
+    {
+        static int Failures = 0;
+
+        return Failures;
+    }
+
+    /// <summary>
+    /// Reports a failed check.
+    /// </summary>
+    inline void Fail(const char * fileName, int line, const char * expression) noexcept
+    {
+        ::fprintf(stderr, "%s(%d): check failed: %s\n", fileName, line, expression);
+
+        ++GetFailures();
+    }
+
+    /// <summary>
+    /// Runs a test case and reports its name.
+    /// </summary>
+    inline void Run(const char * name, void (*testCase)()) noexcept
+    {
+        const int Failures = GetFailures();
+
+        testCase();
+
+        ::printf("%s %s\n", (GetFailures() == Failures) ? "[ OK ]" : "[FAIL]", name);
+    }
+
+    /// <summary>
+    /// The exit code of a test program that can't run because an optional input is missing. CTest reports it as skipped (SKIP_RETURN_CODE).
+    /// </summary>
+    const int SkipExitCode = 77;
+
+    /// <summary>
+    /// Gets the exit code of the test program.
+    /// </summary>
+    inline int GetExitCode() noexcept
+    {
+        if (GetFailures() != 0)
+            ::fprintf(stderr, "%d check(s) failed.\n", GetFailures());
+
+        return (GetFailures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}
+
+#define CHECK(expression) do { if (!(expression)) test::Fail(__FILE__, __LINE__, #expression); } while (false)
+#define RUN(testCase) test::Run(#testCase, testCase)
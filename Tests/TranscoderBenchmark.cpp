@@ -0,0 +1,176 @@
+
+/** $VER: TranscoderBenchmark.cpp (2026.10.17) P. Stuer - Compares the throughput of the transcoder with the converter of the operating system. **/
+
+#include "SystemConverter.h"
+
+#include "Transcoder.h"
+#include "Validators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t CorpusSize = 1 << 20;
+
+    /// <summary>
+    /// The MIDI title of the Data1 test case in Encoding.cpp, in UTF-8: mostly ASCII with a few Japanese words.
+    /// </summary>
+    const char Text1[] = "Final Fantasy 5 [ \xE3\x83\x93\xE3\x83\x83\xE3\x82\xB0\xE3\x83\x96\xE3\x83\xAA\xE3\x83\x83\xE3\x83\x82\xE3\x81\xAE\xE6\xAD\xBB\xE9\x97\x98 \xE2\x80\x99\xEF\xBC\x99\xEF\xBC\x99 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// Repeats the specified text until the corpus is full.
+    /// </summary>
+    std::string Repeat(const char * text, size_t size)
+    {
+        std::string Corpus;
+
+        while (Corpus.size() + size <= CorpusSize)
+            Corpus.append(text, size);
+
+        return Corpus;
+    }
+
+    /// <summary>
+    /// Builds a Japanese text of hiragana and kanji in UTF-8 with a space every 32 characters.
+    /// </summary>
+    std::string MakeJapanese()
+    {
+        std::mt19937 Random(2026);
+
+        std::string Corpus;
+
+        for (size_t n = 0; Corpus.size() + 8 <= CorpusSize; ++n)
+        {
+            if (n % 32 == 31)
+            {
+                Corpus.push_back(' ');
+                continue;
+            }
+
+            const uint32_t c = (Random() % 2 == 0) ? 0x3041 + Random() % 0x53 : 0x4E00 + Random() % 0x5000;
+
+            Corpus.push_back((char) (0xE0 | (c >> 12)));
+            Corpus.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            Corpus.push_back((char) (0x80 | (c & 0x3F)));
+        }
+
+        return Corpus;
+    }
+
+    /// <summary>
+    /// Gets the throughput of a conversion in MB/s of input. The conversion returns false if it fails.
+    /// </summary>
+    template<typename F>
+    double Measure(F convert, size_t size)
+    {
+        double Best = 0.;
+
+        for (int Run = 0; Run < 5; ++Run)
+        {
+            const int Iterations = 20;
+
+            const auto Start = std::chrono::steady_clock::now();
+
+            bool Result = true;
+
+            for (int i = 0; i < Iterations; ++i)
+                Result &= convert();
+
+            const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+            if (!Result)
+                return 0.;
+
+            Best = (std::max)(Best, (double) size * Iterations / Elapsed / 1e6);
+        }
+
+        return Best;
+    }
+}
+
+int main()
+{
+    const struct
+    {
+        const char * Name;
+        std::string Text;
+    }
+    Corpora[] =
+    {
+        { "ASCII",    Repeat("The quick brown fox jumps over the lazy dog. 0123456789 ", 56) },
+        { "Data1",    Repeat(Text1, sizeof(Text1) - 1) },
+        { "Japanese", MakeJapanese() },
+    };
+
+    std::vector<instruction_set_t> InstructionSets;
+
+    for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+    {
+        ::SetInstructionSet(InstructionSet);
+
+        if (::GetInstructionSet() == InstructionSet)
+            InstructionSets.push_back(InstructionSet);
+    }
+
+    ::printf("MB/s on %zu KB        ", CorpusSize / 1024);
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf(" %8s", ::GetInstructionSetName(InstructionSet));
+
+    ::printf(" %8s\n", "System");
+
+    for (const auto & Corpus : Corpora)
+    {
+        std::u16string Wide;
+
+        if (!test::SystemToUTF16(test::system_encoding_t::UTF8, Corpus.Text, Wide))
+        {
+            ::fprintf(stderr, "The %s corpus is not valid.\n", Corpus.Name);
+
+            return 1;
+        }
+
+        // UTF-8 to UTF-16
+        {
+            ::printf("%-8s %-12s", "UTF-8", Corpus.Name);
+
+            std::u16string Buffer(GetUTF16Capacity(Corpus.Text.size()), u'\0');
+
+            for (auto InstructionSet : InstructionSets)
+            {
+                ::SetInstructionSet(InstructionSet);
+
+                ::printf(" %8.0f", Measure([&] { return ::UTF8ToUTF16(Corpus.Text.data(), Corpus.Text.size(), Buffer.data()).IsValid(); }, Corpus.Text.size()));
+            }
+
+            std::u16string Result;
+
+            ::printf(" %8.0f\n", Measure([&] { return test::SystemToUTF16(test::system_encoding_t::UTF8, Corpus.Text, Result); }, Corpus.Text.size()));
+        }
+
+        // UTF-16 to UTF-8
+        {
+            ::printf("%-8s %-12s", "UTF-16", Corpus.Name);
+
+            std::string Buffer(GetUTF8Capacity(Wide.size()), '\0');
+
+            for (auto InstructionSet : InstructionSets)
+            {
+                ::SetInstructionSet(InstructionSet);
+
+                ::printf(" %8.0f", Measure([&] { return ::UTF16ToUTF8(Wide.data(), Wide.size(), Buffer.data()).IsValid(); }, Wide.size() * 2));
+            }
+
+            std::string Result;
+
+            ::printf(" %8.0f\n", Measure([&] { return test::SystemFromUTF16(test::system_encoding_t::UTF8, Wide, Result); }, Wide.size() * 2));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+
+/** $VER: TranscoderTests.cpp (2026.10.17) P. Stuer - Compares the UTF-8 / UTF-16 transcoder with the converter of the operating system. **/
+
+#include "Test.h"
+#include "SystemConverter.h"
+
+#include "Transcoder.h"
+#include "Validators.h"
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<instruction_set_t> GetInstructionSets() noexcept
+    {
+        std::vector<instruction_set_t> InstructionSets;
+
+        for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            if (::GetInstructionSet() == InstructionSet)
+                InstructionSets.push_back(InstructionSet);
+        }
+
+        return InstructionSets;
+    }
+
+    std::vector<instruction_set_t> InstructionSets; // Filled in by main(), once the validators have detected the processor.
+
+    size_t Mismatches = 0;
+
+    /// <summary>
+    /// Reports the first few mismatches so that a broken converter does not flood the output.
+    /// </summary>
+    void ReportMismatch(const char * direction, const std::string & bytes) noexcept
+    {
+        if (++Mismatches > 10)
+            return;
+
+        ::fprintf(stderr, "%s mismatch on", direction);
+
+        for (unsigned char c : bytes)
+            ::fprintf(stderr, " %02X", c);
+
+        ::fprintf(stderr, " (%s)\n", ::GetInstructionSetName(::GetInstructionSet()));
+    }
+
+    std::string ToBytes(const std::u16string & wide)
+    {
+        std::string Bytes;
+
+        for (char16_t c : wide)
+        {
+            Bytes.push_back((char) (c >> 8));
+            Bytes.push_back((char) (c & 0xFF));
+        }
+
+        return Bytes;
+    }
+
+    /// <summary>
+    /// Converts UTF-8 to UTF-16 with the transcoder and with the system converter, and checks that both accept the same texts and give the same result.
+    /// </summary>
+    void CompareUTF8(const std::string & text) noexcept
+    {
+        std::u16string Expected;
+
+        const bool IsValid = test::SystemToUTF16(test::system_encoding_t::UTF8, text, Expected);
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::u16string Wide(GetUTF16Capacity(text.size()), u'\0');
+
+            const transcode_result_t Result = ::UTF8ToUTF16(text.data(), text.size(), Wide.data());
+
+            Wide.resize(Result.Written);
+
+            if ((Result.IsValid() != IsValid) || (IsValid && (Wide != Expected)))
+                ReportMismatch("UTF-8 to UTF-16", text);
+        }
+    }
+
+    /// <summary>
+    /// Converts UTF-16 to UTF-8 with the transcoder and with the system converter, and checks that both accept the same texts and give the same result.
+    /// </summary>
+    void CompareUTF16(const std::u16string & wide) noexcept
+    {
+        std::string Expected;
+
+        const bool IsValid = test::SystemFromUTF16(test::system_encoding_t::UTF8, wide, Expected);
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            std::string Text(GetUTF8Capacity(wide.size()), '\0');
+
+            const transcode_result_t Result = ::UTF16ToUTF8(wide.data(), wide.size(), Text.data());
+
+            Text.resize(Result.Written);
+
+            if ((Result.IsValid() != IsValid) || (IsValid && (Text != Expected)))
+                ReportMismatch("UTF-16 to UTF-8", ToBytes(wide));
+        }
+    }
+
+    void AppendUTF8(std::string & text, uint32_t c)
+    {
+        if (c < 0x80)
+            text.push_back((char) c);
+        else
+        if (c < 0x800)
+        {
+            text.push_back((char) (0xC0 | (c >> 6)));
+            text.push_back((char) (0x80 | (c & 0x3F)));
+        }
+        else
+        if (c < 0x10000)
+        {
+            text.push_back((char) (0xE0 | (c >> 12)));
+            text.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            text.push_back((char) (0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            text.push_back((char) (0xF0 | (c >> 18)));
+            text.push_back((char) (0x80 | ((c >> 12) & 0x3F)));
+            text.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            text.push_back((char) (0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+/// <summary>
+/// Converts every Unicode scalar value in both directions, in blocks that are long enough to use the vectorized paths.
+/// </summary>
+static void AllCodePoints()
+{
+    Mismatches = 0;
+
+    for (uint32_t First = 0; First < 0x110000; First += 0x1000)
+    {
+        std::string Text;
+
+        for (uint32_t c = First; c < First + 0x1000; ++c)
+        {
+            if ((c >= 0xD800) && (c <= 0xDFFF))
+                continue;
+
+            AppendUTF8(Text, c);
+        }
+
+        CompareUTF8(Text);
+
+        std::u16string Wide;
+
+        CHECK(test::SystemToUTF16(test::system_encoding_t::UTF8, Text, Wide));
+
+        CompareUTF16(Wide);
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Converts every sequence of two bytes, followed by a byte that completes, continues or breaks a longer sequence.
+/// </summary>
+static void AllShortSequences()
+{
+    Mismatches = 0;
+
+    static const uint8_t LastBytes[] = { 0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC2, 0xE0, 0xED, 0xF0, 0xF4, 0xFF };
+
+    for (uint32_t i = 0; i < 0x10000; ++i)
+    {
+        std::string Text = { (char) (i >> 8), (char) (i & 0xFF) };
+
+        CompareUTF8(Text);
+
+        if ((i >> 8) < 0xC0)
+            continue; // A third byte can't change the outcome of a text that doesn't start a multi-byte sequence.
+
+        for (uint8_t c : LastBytes)
+        {
+            Text.resize(2);
+            Text.push_back((char) c);
+
+            CompareUTF8(Text);
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Converts every UTF-16 code unit on its own and every surrogate next to a code unit that pairs or doesn't pair with it.
+/// </summary>
+static void AllUTF16Sequences()
+{
+    Mismatches = 0;
+
+    static const char16_t Neighbours[] = { u'A', 0x00E9, 0x3042, 0xD7FF, 0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xE000, 0xFFFF };
+
+    for (uint32_t c = 0; c < 0x10000; ++c)
+    {
+        CompareUTF16(std::u16string(1, (char16_t) c));
+
+        if ((c < 0xD800) || (c > 0xDFFF))
+            continue;
+
+        for (char16_t d : Neighbours)
+        {
+            CompareUTF16({ (char16_t) c, d });
+            CompareUTF16({ d, (char16_t) c });
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+/// <summary>
+/// Converts random texts with runs of ASCII of various lengths, so that the vectorized paths start and stop at every offset.
+/// </summary>
+static void RandomTexts()
+{
+    Mismatches = 0;
+
+    std::mt19937 Random(20261017);
+
+    static const uint32_t CodePoints[] = { 0x00E9, 0x03B1, 0x0416, 0x3042, 0x30A2, 0x6F22, 0xFF76, 0x1F3B5, 0x10FFFF };
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string Text;
+
+        const size_t Runs = Random() % 8;
+
+        for (size_t j = 0; j < Runs; ++j)
+        {
+            const size_t Length = Random() % 40;
+
+            for (size_t k = 0; k < Length; ++k)
+                Text.push_back((char) (0x20 + Random() % 0x5F));
+
+            AppendUTF8(Text, CodePoints[Random() % std::size(CodePoints)]);
+        }
+
+        CompareUTF8(Text);
+
+        std::u16string Wide;
+
+        CHECK(test::SystemToUTF16(test::system_encoding_t::UTF8, Text, Wide));
+
+        CompareUTF16(Wide);
+
+        // Break the text with a byte or a code unit that is not valid where it is inserted.
+        if (!Text.empty())
+        {
+            Text.insert(Text.begin() + (Random() % Text.size()), (char) (0x80 + Random() % 0x80));
+
+            CompareUTF8(Text);
+        }
+
+        if (!Wide.empty())
+        {
+            Wide.insert(Wide.begin() + (Random() % Wide.size()), (char16_t) (0xD800 + Random() % 0x800));
+
+            CompareUTF16(Wide);
+        }
+    }
+
+    CHECK(Mismatches == 0);
+}
+
+int main()
+{
+    InstructionSets = GetInstructionSets();
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf("Testing %s\n", ::GetInstructionSetName(InstructionSet));
+
+    RUN(AllCodePoints);
+    RUN(AllShortSequences);
+    RUN(AllUTF16Sequences);
+    RUN(RandomTexts);
+
+    return test::GetExitCode();
+}
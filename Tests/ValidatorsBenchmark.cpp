@@ -0,0 +1,203 @@
+
+/** $VER: ValidatorsBenchmark.cpp (2026.10.17) P. Stuer - Measures the throughput of the validators for each instruction set. **/
+
+#include "Validators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t CorpusSize = 1 << 20;
+
+    /// <summary>
+    /// The Shift-JIS MIDI title of the Data1 test case in Encoding.cpp: mostly ASCII with a few Japanese words.
+    /// </summary>
+    const unsigned char Data1[] =
+    {
+        0x46, 0x69, 0x6e, 0x61, 0x6c, 0x20, 0x46, 0x61, 0x6e, 0x74, 0x61, 0x73, 0x79, 0x20, 0x35, 0x20, 0x5b, 0x20, 0x83, 0x72, 0x83, 0x62, 0x83, 0x4f,
+        0x83, 0x75, 0x83, 0x8a, 0x83, 0x62, 0x83, 0x61, 0x82, 0xcc, 0x8e, 0x80, 0x93, 0xac, 0x20, 0x81, 0x66, 0x82, 0x58, 0x82, 0x58, 0x20, 0x2d, 0x73,
+        0x69, 0x6e, 0x67, 0x6c, 0x65, 0x20, 0x65, 0x64, 0x69, 0x74, 0x2d, 0x20, 0x5d, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x53, 0x43, 0x2d, 0x38, 0x38, 0x50,
+        0x72, 0x6f, 0x20, 0x32, 0x50, 0x6f, 0x72, 0x74, 0x20, 0x76, 0x65, 0x72, 0x37, 0x2e, 0x30, 0x20, 0x62, 0x79, 0x20, 0x4c, 0x69, 0x78,
+    };
+
+    /// <summary>
+    /// The same title in UTF-8.
+    /// </summary>
+    const char Text1[] = "Final Fantasy 5 [ \xE3\x83\x93\xE3\x83\x83\xE3\x82\xB0\xE3\x83\x96\xE3\x83\xAA\xE3\x83\x83\xE3\x83\x82\xE3\x81\xAE\xE6\xAD\xBB\xE9\x97\x98 \xE2\x80\x99\xEF\xBC\x99\xEF\xBC\x99 -single edit- ] for SC-88Pro 2Port ver7.0 by Lix";
+
+    /// <summary>
+    /// Repeats the specified text until the corpus is full.
+    /// </summary>
+    std::string Repeat(const char * text, size_t size)
+    {
+        std::string Corpus;
+
+        while (Corpus.size() + size <= CorpusSize)
+            Corpus.append(text, size);
+
+        return Corpus;
+    }
+
+    enum class corpus_encoding_t { UTF8, ShiftJIS, EUCJP };
+
+    /// <summary>
+    /// Builds a Japanese text of hiragana and kanji with a space every 32 characters.
+    /// </summary>
+    std::string MakeJapanese(corpus_encoding_t encoding)
+    {
+        std::mt19937 Random(2026);
+
+        std::string Corpus;
+
+        for (size_t n = 0; Corpus.size() + 8 <= CorpusSize; ++n)
+        {
+            if (n % 32 == 31)
+            {
+                Corpus.push_back(' ');
+                continue;
+            }
+
+            switch (encoding)
+            {
+                case corpus_encoding_t::UTF8:
+                {
+                    const uint32_t c = (Random() % 2 == 0) ? 0x3041 + Random() % 0x53 : 0x4E00 + Random() % 0x5000;
+
+                    Corpus.push_back((char) (0xE0 | (c >> 12)));
+                    Corpus.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+                    Corpus.push_back((char) (0x80 | (c & 0x3F)));
+                    break;
+                }
+
+                case corpus_encoding_t::ShiftJIS:
+                {
+                    // Hiragana (0x829F to 0x82F1) or kanji (lead bytes 0x88 to 0x9F).
+                    if (Random() % 2 == 0)
+                    {
+                        Corpus.push_back((char) 0x82);
+                        Corpus.push_back((char) (0x9F + Random() % 0x53));
+                    }
+                    else
+                    {
+                        Corpus.push_back((char) (0x89 + Random() % 0x17));
+                        Corpus.push_back((char) (0x80 + Random() % 0x7D));
+                    }
+                    break;
+                }
+
+                case corpus_encoding_t::EUCJP:
+                {
+                    // Hiragana (row 4) or kanji (rows 16 to 79).
+                    Corpus.push_back((char) ((Random() % 2 == 0) ? 0xA4 : 0xB0 + Random() % 0x40));
+                    Corpus.push_back((char) (0xA1 + Random() % 0x53));
+                    break;
+                }
+            }
+        }
+
+        return Corpus;
+    }
+
+    /// <summary>
+    /// Gets the throughput of a validator in GB/s. The corpus must be valid so the validator reads all of it.
+    /// </summary>
+    double Measure(bool (*validator)(const char *, size_t) noexcept, const std::string & corpus)
+    {
+        if (!validator(corpus.data(), corpus.size()))
+        {
+            ::fprintf(stderr, "The corpus is not valid.\n");
+
+            return 0.;
+        }
+
+        double Best = 0.;
+
+        for (int Run = 0; Run < 5; ++Run)
+        {
+            const int Iterations = 50;
+
+            const auto Start = std::chrono::steady_clock::now();
+
+            bool Result = true;
+
+            for (int i = 0; i < Iterations; ++i)
+                Result &= validator(corpus.data(), corpus.size());
+
+            const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+            if (Result)
+                Best = (std::max)(Best, (double) corpus.size() * Iterations / Elapsed / 1e9);
+        }
+
+        return Best;
+    }
+}
+
+int main()
+{
+    const std::string ASCII = Repeat("The quick brown fox jumps over the lazy dog. 0123456789 ", 56);
+    const std::string Mixed = Repeat(Text1, sizeof(Text1) - 1);
+    const std::string ShiftJIS = Repeat((const char *) Data1, sizeof(Data1));
+    const std::string JapaneseUTF8 = MakeJapanese(corpus_encoding_t::UTF8);
+    const std::string JapaneseShiftJIS = MakeJapanese(corpus_encoding_t::ShiftJIS);
+    const std::string JapaneseEUCJP = MakeJapanese(corpus_encoding_t::EUCJP);
+
+    const struct
+    {
+        const char * Name;
+        bool (*Validator)(const char *, size_t) noexcept;
+        const char * CorpusName;
+        const std::string & Corpus;
+    }
+    Cases[] =
+    {
+        { "IsASCII",    ::IsASCII,    "ASCII",            ASCII },
+        { "IsUTF8",     ::IsUTF8,     "ASCII",            ASCII },
+        { "IsUTF8",     ::IsUTF8,     "Data1 (UTF-8)",    Mixed },
+        { "IsUTF8",     ::IsUTF8,     "Japanese (UTF-8)", JapaneseUTF8 },
+        { "IsShiftJIS", ::IsShiftJIS, "ASCII",            ASCII },
+        { "IsShiftJIS", ::IsShiftJIS, "Data1",            ShiftJIS },
+        { "IsShiftJIS", ::IsShiftJIS, "Japanese (SJIS)",  JapaneseShiftJIS },
+        { "IsEUCJP",    ::IsEUCJP,    "ASCII",            ASCII },
+        { "IsEUCJP",    ::IsEUCJP,    "Japanese (EUC)",   JapaneseEUCJP },
+    };
+
+    std::vector<instruction_set_t> InstructionSets;
+
+    for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+    {
+        ::SetInstructionSet(InstructionSet);
+
+        if (::GetInstructionSet() == InstructionSet)
+            InstructionSets.push_back(InstructionSet);
+    }
+
+    ::printf("GB/s on %zu KB             ", CorpusSize / 1024);
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf(" %8s", ::GetInstructionSetName(InstructionSet));
+
+    ::printf("\n");
+
+    for (const auto & Case : Cases)
+    {
+        ::printf("%-10s %-18s", Case.Name, Case.CorpusName);
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            ::printf(" %8.2f", Measure(Case.Validator, Case.Corpus));
+        }
+
+        ::printf("\n");
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,344 @@
+
+/** $VER: ValidatorsTests.cpp (2026.10.17) P. Stuer - Compares the vectorized validators with the scalar ones and with a reference UTF-8 decoder. **/
+
+#include "Test.h"
+
+#include "Validators.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// <summary>
+    /// Decodes each sequence and checks its length and value, independently of the validators.
+    /// </summary>
+    bool IsUTF8Reference(const std::string & text) noexcept
+    {
+        const uint8_t * Data = (const uint8_t *) text.data();
+        const size_t Size = text.size();
+
+        for (size_t i = 0; i < Size;)
+        {
+            const uint8_t c = Data[i];
+
+            size_t Length;
+            uint32_t CodePoint;
+
+            if (c < 0x80) { ++i; continue; }
+            else
+            if ((c & 0xE0) == 0xC0) { Length = 2; CodePoint = c & 0x1F; }
+            else
+            if ((c & 0xF0) == 0xE0) { Length = 3; CodePoint = c & 0x0F; }
+            else
+            if ((c & 0xF8) == 0xF0) { Length = 4; CodePoint = c & 0x07; }
+            else
+                return false;
+
+            if (i + Length > Size)
+                return false;
+
+            for (size_t j = 1; j < Length; ++j)
+            {
+                if ((Data[i + j] & 0xC0) != 0x80)
+                    return false;
+
+                CodePoint = (CodePoint << 6) | (Data[i + j] & 0x3F);
+            }
+
+            static const uint32_t MinCodePoint[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+            if ((CodePoint < MinCodePoint[Length]) || (CodePoint > 0x10FFFF) || ((CodePoint >= 0xD800) && (CodePoint <= 0xDFFF)))
+                return false;
+
+            i += Length;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the instruction sets supported by the processor, starting with the scalar one.
+    /// </summary>
+    std::vector<instruction_set_t> GetInstructionSets() noexcept
+    {
+        std::vector<instruction_set_t> InstructionSets;
+
+        for (auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2 })
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            if (::GetInstructionSet() == InstructionSet)
+                InstructionSets.push_back(InstructionSet);
+        }
+
+        return InstructionSets;
+    }
+
+    std::vector<instruction_set_t> InstructionSets; // Filled in by main(), once the validators have detected the processor.
+
+    size_t Mismatches = 0;
+
+    /// <summary>
+    /// Compares every validator of every instruction set with the scalar one on the specified text.
+    /// </summary>
+    void Compare(const std::string & text) noexcept
+    {
+        const char * Text = text.data();
+        const size_t Size = text.size();
+
+        const bool IsASCII    = scalar::IsASCII(Text, Size);
+        const bool IsUTF8     = scalar::IsUTF8(Text, Size);
+        const bool IsShiftJIS = scalar::IsShiftJIS(Text, Size);
+        const bool IsEUCJP    = scalar::IsEUCJP(Text, Size);
+        const size_t Skipped  = scalar::SkipASCII(Text, Size);
+
+        bool IsMatch = (IsUTF8 == IsUTF8Reference(text));
+
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            IsMatch = IsMatch
+                   && (::IsASCII(Text, Size) == IsASCII)
+                   && (::IsUTF8(Text, Size) == IsUTF8)
+                   && (::IsShiftJIS(Text, Size) == IsShiftJIS)
+                   && (::IsEUCJP(Text, Size) == IsEUCJP)
+                   && (::SkipASCII(Text, Size) == Skipped);
+        }
+
+        if (!IsMatch)
+        {
+            if (Mismatches++ < 10)
+            {
+                ::fprintf(stderr, "Mismatch on %zu bytes:", Size);
+
+                for (const char c : text)
+                    ::fprintf(stderr, " %02X", (uint8_t) c);
+
+                ::fprintf(stderr, "\n");
+            }
+        }
+    }
+
+    /// <summary>
+    /// Places a byte sequence at the specified offset in an ASCII text of the specified size.
+    /// </summary>
+    std::string Embed(const uint8_t * sequence, size_t length, size_t offset, size_t size)
+    {
+        std::string Text(size, 'a');
+
+        ::memcpy(Text.data() + offset, sequence, length);
+
+        return Text;
+    }
+
+    /// <summary>
+    /// Every 1- and 2-byte sequence at every offset around the 16- and 32-byte block boundaries, at the end of the text and followed by ASCII.
+    /// </summary>
+    void AllShortSequences()
+    {
+        Mismatches = 0;
+
+        for (uint32_t i = 0; i < 0x10000; ++i)
+        {
+            const uint8_t Sequence[2] = { (uint8_t) (i >> 8), (uint8_t) i };
+
+            for (size_t Offset : { 0, 14, 15, 16, 30, 31, 32, 62, 63 })
+            {
+                Compare(Embed(Sequence, 2, Offset, Offset + 2));
+                Compare(Embed(Sequence, 2, Offset, 70));
+            }
+        }
+
+        CHECK(Mismatches == 0);
+    }
+
+    /// <summary>
+    /// Every 3-byte sequence that starts with a byte of 0x80 or higher, straddling the 32-byte block boundary. 4-byte sequences are built from the boundary values of each byte.
+    /// </summary>
+    void AllLongSequences()
+    {
+        Mismatches = 0;
+
+        for (uint32_t i = 0x800000; i < 0x1000000; ++i)
+        {
+            const uint8_t Sequence[3] = { (uint8_t) (i >> 16), (uint8_t) (i >> 8), (uint8_t) i };
+
+            Compare(Embed(Sequence, 3, 30, 40));
+        }
+
+        static const uint8_t Boundaries[] = { 0x00, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xA1, 0xBF, 0xC0, 0xDF, 0xE0, 0xEF, 0xF0, 0xF4, 0xF5, 0xFE, 0xFF };
+
+        for (uint32_t d1 = 0xF0; d1 <= 0xFF; ++d1)
+            for (uint8_t d2 : Boundaries)
+                for (uint8_t d3 : Boundaries)
+                    for (uint8_t d4 : Boundaries)
+                    {
+                        const uint8_t Sequence[4] = { (uint8_t) d1, d2, d3, d4 };
+
+                        for (size_t Offset = 28; Offset <= 32; ++Offset)
+                        {
+                            Compare(Embed(Sequence, 4, Offset, Offset + 4));
+                            Compare(Embed(Sequence, 4, Offset, 70));
+                        }
+                    }
+
+        CHECK(Mismatches == 0);
+    }
+
+    /// <summary>
+    /// Random texts: random bytes, and valid UTF-8, Shift-JIS and EUC-JP texts with a few bytes changed.
+    /// </summary>
+    void RandomTexts()
+    {
+        Mismatches = 0;
+
+        std::mt19937 Random(2026);
+
+        auto Next = [&Random](uint32_t lo, uint32_t hi) { return (uint32_t) std::uniform_int_distribution<uint32_t>(lo, hi)(Random); };
+
+        for (int n = 0; n < 200000; ++n)
+        {
+            const size_t Size = Next(0, 300);
+
+            std::string Text;
+
+            switch (n % 4)
+            {
+                case 0:
+                {
+                    // Mostly ASCII with some high bytes.
+                    while (Text.size() < Size)
+                        Text.push_back((char) ((Next(0, 3) == 0) ? Next(0x80, 0xFF) : Next(0x20, 0x7E)));
+                    break;
+                }
+
+                case 1:
+                {
+                    // Valid UTF-8.
+                    while (Text.size() < Size)
+                    {
+                        uint32_t c;
+
+                        do
+                        {
+                            static const uint32_t Limits[] = { 0x7F, 0x7FF, 0xFFFF, 0x10FFFF };
+
+                            c = Next(0, Limits[Next(0, 3)]);
+                        }
+                        while ((c >= 0xD800) && (c <= 0xDFFF));
+
+                        if (c < 0x80)    { Text.push_back((char) c); }
+                        else
+                        if (c < 0x800)   { Text.push_back((char) (0xC0 | (c >> 6))); Text.push_back((char) (0x80 | (c & 0x3F))); }
+                        else
+                        if (c < 0x10000) { Text.push_back((char) (0xE0 | (c >> 12))); Text.push_back((char) (0x80 | ((c >> 6) & 0x3F))); Text.push_back((char) (0x80 | (c & 0x3F))); }
+                        else             { Text.push_back((char) (0xF0 | (c >> 18))); Text.push_back((char) (0x80 | ((c >> 12) & 0x3F))); Text.push_back((char) (0x80 | ((c >> 6) & 0x3F))); Text.push_back((char) (0x80 | (c & 0x3F))); }
+                    }
+                    break;
+                }
+
+                case 2:
+                {
+                    // Valid Shift-JIS.
+                    while (Text.size() < Size)
+                    {
+                        // Mostly double-byte characters, so the vectorized paths see long runs of them.
+                        switch (Next(0, 15))
+                        {
+                            case 0: Text.push_back((char) Next(0x20, 0x7E)); break;
+                            case 1: Text.push_back((char) Next(0xA1, 0xDF)); break;
+                            default:
+                                Text.push_back((char) ((Next(0, 1) == 0) ? Next(0x81, 0x9F) : Next(0xE0, 0xFC)));
+                                Text.push_back((char) ((Next(0, 1) == 0) ? Next(0x40, 0x7E) : Next(0x80, 0xFC)));
+                        }
+                    }
+                    break;
+                }
+
+                default:
+                {
+                    // Valid EUC-JP.
+                    while (Text.size() < Size)
+                    {
+                        switch (Next(0, 15))
+                        {
+                            case 0: Text.push_back((char) Next(0x20, 0x7E)); break;
+                            case 1: Text.push_back((char) 0x8E); Text.push_back((char) Next(0xA1, 0xDF)); break;
+                            case 2: Text.push_back((char) 0x8F); Text.push_back((char) Next(0xA1, 0xFE)); Text.push_back((char) Next(0xA1, 0xFE)); break;
+                            default: Text.push_back((char) Next(0xA1, 0xFE)); Text.push_back((char) Next(0xA1, 0xFE));
+                        }
+                    }
+                    break;
+                }
+            }
+
+            Compare(Text);
+
+            if (Text.empty())
+                continue;
+
+            // Change, insert or remove a byte.
+            for (int k = Next(1, 3); k > 0; --k)
+            {
+                const size_t Position = Next(0, (uint32_t) Text.size() - 1);
+
+                switch (Next(0, 2))
+                {
+                    case 0: Text[Position] = (char) Next(0, 0xFF); break;
+                    case 1: Text.insert(Text.begin() + (ptrdiff_t) Position, (char) Next(0x80, 0xFF)); break;
+                    default: if (Text.size() > 1) Text.erase(Text.begin() + (ptrdiff_t) Position); break;
+                }
+            }
+
+            Compare(Text);
+        }
+
+        CHECK(Mismatches == 0);
+    }
+
+    /// <summary>
+    /// Known valid and invalid sequences.
+    /// </summary>
+    void KnownSequences()
+    {
+        for (auto InstructionSet : InstructionSets)
+        {
+            ::SetInstructionSet(InstructionSet);
+
+            CHECK(::IsUTF8("\xE3\x81\x82", 3));              // U+3042
+            CHECK(::IsUTF8("\xF4\x8F\xBF\xBF", 4));          // U+10FFFF
+            CHECK(!::IsUTF8("\xC0\xAF", 2));                 // Overlong
+            CHECK(!::IsUTF8("\xED\xA0\x80", 3));             // Surrogate
+            CHECK(!::IsUTF8("\xF4\x90\x80\x80", 4));         // Above U+10FFFF
+            CHECK(!::IsUTF8("\x80", 1));                     // Stray continuation byte
+            CHECK(!::IsUTF8("\xE3\x81", 2));                 // Truncated
+
+            CHECK(::IsShiftJIS("\x82\xA0", 2));              // U+3042
+            CHECK(!::IsShiftJIS("\x83", 1));                 // Truncated
+            CHECK(!::IsShiftJIS("\x81\x20", 2));             // Invalid trail byte
+
+            CHECK(::IsEUCJP("\xA4\xA2", 2));                 // U+3042
+            CHECK(::IsEUCJP("\x8E\xB1", 2));                 // Half-width katakana
+            CHECK(!::IsEUCJP("\xA4\x41", 2));                // Invalid trail byte
+        }
+    }
+}
+
+int main()
+{
+    InstructionSets = GetInstructionSets();
+
+    for (auto InstructionSet : InstructionSets)
+        ::printf("Testing %s\n", ::GetInstructionSetName(InstructionSet));
+
+    RUN(KnownSequences);
+    RUN(AllShortSequences);
+    RUN(AllLongSequences);
+    RUN(RandomTexts);
+
+    return test::GetExitCode();
+}
@@ -0,0 +1,79 @@
+
+/** $VER: TitleFormatCache.cpp (2026.10.17) P. Stuer - Caches compiled Title Formatting scripts. **/
+
+#include "pch.h"
+
+#include "TitleFormatCache.h"
+#include "Resources.h"
+
+#pragma hdrstop
+
+titleformat_cache_t _TitleFormatCache(256);
+
+/// <summary>
+/// Gets the compiled version of the specified text. Returns false if the text does not compile. Failures are cached too so they are reported only once.
+/// </summary>
+bool titleformat_cache_t::Get(const pfc::string8 & text, titleformat_object::ptr & object) noexcept
+{
+    try
+    {
+        const std::string Key(text.c_str(), text.length());
+
+        auto Item = _Index.find(Key);
+
+        if (Item != _Index.end())
+        {
+            ++_Hits;
+
+            _Entries.splice(_Entries.begin(), _Entries, Item->second);
+
+            object = Item->second->Object;
+
+            return object.is_valid();
+        }
+
+        ++_Misses;
+
+        titleformat_object::ptr Object;
+
+        if (!titleformat_compiler::get()->compile(Object, text))
+        {
+            console::printf(STR_COMPONENT_NAME " failed to compile \"%s\".", text.c_str());
+
+            Object.release();
+        }
+
+        if (_Entries.size() >= _Capacity)
+        {
+            _Index.erase(_Entries.back().Text);
+            _Entries.pop_back();
+        }
+
+        _Entries.push_front({ Key, Object });
+        _Index[Key] = _Entries.begin();
+
+        object = Object;
+
+        return object.is_valid();
+    }
+    catch (std::exception & e)
+    {
+        console::printf(STR_COMPONENT_NAME " failed to compile \"%s\": %s", text.c_str(), e.what());
+
+        // The list and the index may be out of sync.
+        Clear();
+
+        object.release();
+
+        return false;
+    }
+}
+
+/// <summary>
+/// Removes all entries from the cache.
+/// </summary>
+void titleformat_cache_t::Clear() noexcept
+{
+    _Index.clear();
+    _Entries.clear();
+}
@@ -0,0 +1,51 @@
+
+/** $VER: TitleFormatCache.h (2026.10.17) P. Stuer - Caches compiled Title Formatting scripts. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <SDK/titleformat.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// Implements a bounded LRU cache of compiled Title Formatting scripts, shared by all instances of the panel. Must be used from the main thread.
+/// </summary>
+class titleformat_cache_t
+{
+public:
+    titleformat_cache_t(size_t capacity) noexcept : _Capacity(capacity), _Hits(), _Misses() { }
+
+    titleformat_cache_t(const titleformat_cache_t &) = delete;
+    titleformat_cache_t & operator=(const titleformat_cache_t &) = delete;
+    titleformat_cache_t(titleformat_cache_t &&) = delete;
+    titleformat_cache_t & operator=(titleformat_cache_t &&) = delete;
+
+    bool Get(const pfc::string8 & text, titleformat_object::ptr & object) noexcept;
+    void Clear() noexcept;
+
+    size_t GetCount() const noexcept { return _Entries.size(); }
+
+    uint64_t GetHits() const noexcept { return _Hits; }
+    uint64_t GetMisses() const noexcept { return _Misses; }
+
+private:
+    struct entry_t
+    {
+        std::string Text;
+        titleformat_object::ptr Object; // Null if the text failed to compile.
+    };
+
+    size_t _Capacity;
+
+    std::list<entry_t> _Entries; // Most recently used entry first.
+    std::unordered_map<std::string, std::list<entry_t>::iterator> _Index;
+
+    uint64_t _Hits;
+    uint64_t _Misses;
+};
+
+extern titleformat_cache_t _TitleFormatCache;
@@ -0,0 +1,173 @@
+
+/** $VER: Tracer.cpp (2026.10.17) P. Stuer - Records the panel lifecycle and events in Chrome trace format. **/
+
+#include "pch.h"
+
+#include "Tracer.h"
+#include "Configuration.h"
+#include "Encoding.h"
+#include "Exceptions.h"
+#include "Resources.h"
+#include "WebViewEnvironment.h"
+
+#include <SDK/initquit.h>
+
+#include <format>
+#include <iterator>
+
+#pragma hdrstop
+
+/// <summary>
+/// Reads the setting and allocates the ring buffer if tracing is enabled.
+/// </summary>
+void tracer_t::Initialize() noexcept
+{
+    if (!TraceEnabledCfg.get())
+        return;
+
+    LARGE_INTEGER Frequency;
+
+    ::QueryPerformanceFrequency(&Frequency);
+
+    _Frequency = Frequency.QuadPart;
+    _Origin = Now();
+
+    _Events.reset(new (std::nothrow) event_t[Capacity]);
+
+    _IsEnabled = (_Events != nullptr);
+}
+
+/// <summary>
+/// Records an event with a duration.
+/// </summary>
+void tracer_t::Record(const char * name, uint32_t lane, int64_t start, int64_t end) noexcept
+{
+    if (IsEnabled())
+        Add(name, lane, start, end, false);
+}
+
+/// <summary>
+/// Records an event that happens at this moment.
+/// </summary>
+void tracer_t::Record(const char * name, uint32_t lane) noexcept
+{
+    if (!IsEnabled())
+        return;
+
+    const int64_t Time = Now();
+
+    Add(name, lane, Time, Time, true);
+}
+
+/// <summary>
+/// Adds an event to the ring buffer, overwriting the oldest one when the buffer is full.
+/// </summary>
+void tracer_t::Add(const char * name, uint32_t lane, int64_t start, int64_t end, bool isInstant) noexcept
+{
+    const size_t Index = _Count.fetch_add(1, std::memory_order_relaxed);
+
+    _Events[Index & (Capacity - 1)] = { name, lane, isInstant, start, end };
+}
+
+/// <summary>
+/// Writes the recorded events to the specified file, oldest first. The text grows as needed; the event names are escaped.
+/// </summary>
+bool tracer_t::Write(const std::wstring & filePath) const noexcept
+{
+    const size_t Count = _Count.load(std::memory_order_relaxed);
+
+    if (!_IsEnabled || (Count == 0))
+        return false;
+
+    const size_t First = (Count > Capacity) ? Count - Capacity : 0;
+
+    const DWORD ProcessId = ::GetCurrentProcessId();
+
+    // Converts performance counter ticks to microseconds since the tracer was initialized.
+    auto ToMicroseconds = [this](int64_t ticks) { return (double) (ticks - _Origin) * 1'000'000. / (double) _Frequency; };
+
+    std::string Text;
+
+    Text.reserve((Count - First) * 96 + 256);
+
+    Text.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    std::format_to(std::back_inserter(Text), "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"tid\":0,\"args\":{{\"name\":\"" STR_COMPONENT_BASENAME "\"}}}}", ProcessId);
+
+    for (size_t i = First; i < Count; ++i)
+    {
+        const event_t & Event = _Events[i & (Capacity - 1)];
+
+        const std::string Name = ::ToJSONString(Event.Name);
+
+        if (Event.IsInstant)
+            std::format_to(std::back_inserter(Text), ",\n{{\"name\":{},\"ph\":\"i\",\"s\":\"t\",\"pid\":{},\"tid\":{},\"ts\":{:.3f}}}", Name, ProcessId, Event.Lane, ToMicroseconds(Event.Start));
+        else
+            std::format_to(std::back_inserter(Text), ",\n{{\"name\":{},\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", Name, ProcessId, Event.Lane, ToMicroseconds(Event.Start), ToMicroseconds(Event.End) - ToMicroseconds(Event.Start));
+    }
+
+    Text.append("\n]}\n");
+
+    HANDLE hFile = ::CreateFileW(filePath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        console::printf(::GetErrorMessage(::GetLastError(), std::format(STR_COMPONENT_BASENAME " failed to create trace file \"{}\"", ::WideToUTF8(filePath))).c_str());
+
+        return false;
+    }
+
+    DWORD BytesWritten = 0;
+
+    const BOOL Success = ::WriteFile(hFile, Text.c_str(), (DWORD) Text.size(), &BytesWritten, nullptr);
+
+    ::CloseHandle(hFile);
+
+    if (!Success)
+    {
+        console::printf(::GetErrorMessage(::GetLastError(), STR_COMPONENT_BASENAME " failed to write trace file").c_str());
+
+        return false;
+    }
+
+    console::printf(STR_COMPONENT_BASENAME " wrote %zu trace events to \"%s\".", Count - First, ::WideToUTF8(filePath).c_str());
+
+    return true;
+}
+
+/// <summary>
+/// Gets a new lane for a panel instance.
+/// </summary>
+uint32_t tracer_t::GetNextLane() noexcept
+{
+    static std::atomic<uint32_t> Lane = ProcessLane;
+
+    return ++Lane;
+}
+
+tracer_t _Tracer;
+
+namespace
+{
+    /// <summary>
+    /// Starts the clock of the trace when foobar2000 initializes and writes the trace when it shuts down.
+    /// </summary>
+    class tracer_initquit_t : public initquit
+    {
+    public:
+        void on_init() noexcept override
+        {
+            (void) _Tracer.IsEnabled(); // The time stamps of the trace are relative to the first call.
+        }
+
+        void on_quit() noexcept override
+        {
+            if (!_Tracer.IsEnabled())
+                return;
+
+            (void) _Tracer.Write(_WebViewEnvironment.GetUserDataFolderPath() + L"\\trace.json");
+        }
+    };
+
+    static initquit_factory_t<tracer_initquit_t> _InitQuitFactory;
+}
@@ -0,0 +1,106 @@
+
+/** $VER: Tracer.h (2026.10.17) P. Stuer - Records the panel lifecycle and events in Chrome trace format. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/// <summary>
+/// Records timed events in a ring buffer and writes them as a Chrome trace (chrome://tracing, Perfetto). Enabled in Advanced Preferences; does nothing otherwise.
+/// The event names must be string literals. Each panel records its events in its own lane.
+/// </summary>
+class tracer_t
+{
+public:
+    tracer_t() noexcept : _IsEnabled(), _Frequency(), _Origin(), _Count() { }
+
+    tracer_t(const tracer_t &) = delete;
+    tracer_t & operator=(const tracer_t &) = delete;
+    tracer_t(tracer_t &&) = delete;
+    tracer_t & operator=(tracer_t &&) = delete;
+
+    bool IsEnabled() noexcept
+    {
+        std::call_once(_InitializeFlag, [this] { Initialize(); });
+
+        return _IsEnabled;
+    }
+
+    /// <summary>
+    /// Gets the current time in performance counter ticks.
+    /// </summary>
+    static int64_t Now() noexcept
+    {
+        LARGE_INTEGER Counter;
+
+        ::QueryPerformanceCounter(&Counter);
+
+        return Counter.QuadPart;
+    }
+
+    void Record(const char * name, uint32_t lane, int64_t start, int64_t end) noexcept;
+    void Record(const char * name, uint32_t lane) noexcept;
+
+    bool Write(const std::wstring & filePath) const noexcept;
+
+    static uint32_t GetNextLane() noexcept;
+
+    static const uint32_t ProcessLane = 0; // The lane for events that don't belong to a panel.
+
+private:
+    void Initialize() noexcept;
+    void Add(const char * name, uint32_t lane, int64_t start, int64_t end, bool isInstant) noexcept;
+
+private:
+    struct event_t
+    {
+        const char * Name;
+        uint32_t Lane;
+        bool IsInstant;
+        int64_t Start;
+        int64_t End;
+    };
+
+    static const size_t Capacity = 65536; // Must be a power of 2.
+
+    std::once_flag _InitializeFlag;
+    bool _IsEnabled;
+
+    int64_t _Frequency;
+    int64_t _Origin;
+
+    std::unique_ptr<event_t[]> _Events;
+    std::atomic<size_t> _Count;
+};
+
+extern tracer_t _Tracer;
+
+/// <summary>
+/// Records the lifetime of a scope.
+/// </summary>
+class trace_scope_t
+{
+public:
+    trace_scope_t(const char * name, uint32_t lane) noexcept : _Name(name), _Lane(lane), _Start(_Tracer.IsEnabled() ? tracer_t::Now() : 0) { }
+
+    ~trace_scope_t() noexcept
+    {
+        if (_Start != 0)
+            _Tracer.Record(_Name, _Lane, _Start, tracer_t::Now());
+    }
+
+    trace_scope_t(const trace_scope_t &) = delete;
+    trace_scope_t & operator=(const trace_scope_t &) = delete;
+    trace_scope_t(trace_scope_t &&) = delete;
+    trace_scope_t & operator=(trace_scope_t &&) = delete;
+
+private:
+    const char * _Name;
+    uint32_t _Lane;
+    int64_t _Start;
+};
@@ -0,0 +1,286 @@
+
+/** $VER: Transcoder.cpp (2026.10.17) P. Stuer - Converts between UTF-8 and UTF-16 in a single pass. **/
+
+#include "Transcoder.h"
+#include "Validators.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSCODER_X86
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_SSE2
+#endif
+
+namespace
+{
+#ifdef TRANSCODER_X86
+    /// <summary>
+    /// Widens the leading ASCII bytes of the input 16 at a time. Returns the number of bytes converted.
+    /// </summary>
+    TARGET_SSE2 size_t ConvertASCIIToUTF16(const uint8_t * src, size_t size, char16_t * dst) noexcept
+    {
+        const __m128i Zero = _mm_setzero_si128();
+
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i Bytes = _mm_loadu_si128((const __m128i *) (src + i));
+
+            if (_mm_movemask_epi8(Bytes) != 0)
+                break;
+
+            _mm_storeu_si128((__m128i *) (dst + i),     _mm_unpacklo_epi8(Bytes, Zero));
+            _mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpackhi_epi8(Bytes, Zero));
+        }
+
+        return i;
+    }
+
+    /// <summary>
+    /// Narrows the leading ASCII code units of the input 16 at a time. Returns the number of code units converted.
+    /// </summary>
+    TARGET_SSE2 size_t ConvertASCIIToUTF8(const char16_t * src, size_t size, char * dst) noexcept
+    {
+        const __m128i NonASCII = _mm_set1_epi16((short) 0xFF80);
+        const __m128i Zero = _mm_setzero_si128();
+
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i Lo = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i Hi = _mm_loadu_si128((const __m128i *) (src + i + 8));
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(Lo, Hi), NonASCII), Zero)) != 0xFFFF)
+                break;
+
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(Lo, Hi));
+        }
+
+        return i;
+    }
+#endif
+
+    size_t ConvertASCIIToUTF16Scalar(const uint8_t * src, size_t size, char16_t * dst) noexcept
+    {
+        size_t i = 0;
+
+        while ((i < size) && (src[i] < 0x80))
+        {
+            dst[i] = src[i];
+            ++i;
+        }
+
+        return i;
+    }
+
+    size_t ConvertASCIIToUTF8Scalar(const char16_t * src, size_t size, char * dst) noexcept
+    {
+        size_t i = 0;
+
+        while ((i < size) && (src[i] < 0x80))
+        {
+            dst[i] = (char) src[i];
+            ++i;
+        }
+
+        return i;
+    }
+}
+
+/// <summary>
+/// Widens the leading ASCII bytes of the input to UTF-16. Returns the number of bytes converted.
+/// </summary>
+size_t WidenASCII(const char * src, size_t size, char16_t * dst) noexcept
+{
+    const uint8_t * Src = (const uint8_t *) src;
+
+#ifdef TRANSCODER_X86
+    if (GetInstructionSet() != instruction_set_t::Scalar)
+    {
+        const size_t n = ConvertASCIIToUTF16(Src, size, dst);
+
+        return n + ConvertASCIIToUTF16Scalar(Src + n, std::min<size_t>(size - n, 16), dst + n);
+    }
+#endif
+
+    return ConvertASCIIToUTF16Scalar(Src, size, dst);
+}
+
+/// <summary>
+/// Converts UTF-8 to UTF-16. The destination must hold at least GetUTF16Capacity(size) code units. Stops at the first invalid or truncated sequence.
+/// </summary>
+transcode_result_t UTF8ToUTF16(const char * src, size_t size, char16_t * dst) noexcept
+{
+    const uint8_t * Src = (const uint8_t *) src;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < size)
+    {
+        uint32_t c = Src[i];
+
+        if (c < 0x80)
+        {
+            const size_t n = WidenASCII(src + i, size - i, dst + j);
+
+            i += n;
+            j += n;
+
+            continue;
+        }
+
+        size_t Length;
+        uint8_t Lo = 0x80, Hi = 0xBF; // Range of the second byte
+
+        if ((c >= 0xC2) && (c <= 0xDF)) { Length = 2; c &= 0x1F; }
+        else
+        if ((c >= 0xE0) && (c <= 0xEF))
+        {
+            Length = 3; c &= 0x0F;
+
+            if (c == 0x00) Lo = 0xA0; else  // Overlong
+            if (c == 0x0D) Hi = 0x9F;       // U+D800 to U+DFFF
+        }
+        else
+        if ((c >= 0xF0) && (c <= 0xF4))
+        {
+            Length = 4; c &= 0x07;
+
+            if (c == 0x00) Lo = 0x90; else  // Overlong
+            if (c == 0x04) Hi = 0x8F;       // Above U+10FFFF
+        }
+        else
+            return { i, j, transcode_error_t::InvalidSequence };
+
+        for (size_t k = 1; k < Length; ++k)
+        {
+            if (i + k == size)
+                return { i, j, transcode_error_t::Truncated };
+
+            const uint8_t d = Src[i + k];
+
+            if ((k == 1) ? ((d < Lo) || (d > Hi)) : ((d & 0xC0) != 0x80))
+                return { i, j, transcode_error_t::InvalidSequence };
+
+            c = (c << 6) | (d & 0x3F);
+        }
+
+        if (c < 0x10000)
+            dst[j++] = (char16_t) c;
+        else
+        {
+            c -= 0x10000;
+
+            dst[j++] = (char16_t) (0xD800 + (c >> 10));
+            dst[j++] = (char16_t) (0xDC00 + (c & 0x3FF));
+        }
+
+        i += Length;
+    }
+
+    return { i, j, transcode_error_t::None };
+}
+
+/// <summary>
+/// Converts UTF-16 to UTF-8. The destination must hold at least GetUTF8Capacity(size) bytes. Stops at the first unpaired surrogate.
+/// </summary>
+transcode_result_t UTF16ToUTF8(const char16_t * src, size_t size, char * dst) noexcept
+{
+#ifdef TRANSCODER_X86
+    const bool UseSSE2 = (GetInstructionSet() != instruction_set_t::Scalar);
+#endif
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < size)
+    {
+        uint32_t c = src[i];
+
+        if (c < 0x80)
+        {
+            size_t n;
+
+        #ifdef TRANSCODER_X86
+            if (UseSSE2)
+            {
+                n = ConvertASCIIToUTF8(src + i, size - i, dst + j);
+
+                n += ConvertASCIIToUTF8Scalar(src + i + n, std::min<size_t>(size - i - n, 16), dst + j + n);
+            }
+            else
+        #endif
+                n = ConvertASCIIToUTF8Scalar(src + i, size - i, dst + j);
+
+            i += n;
+            j += n;
+
+            continue;
+        }
+
+        if (c < 0x800)
+        {
+            dst[j++] = (char) (0xC0 | (c >> 6));
+            dst[j++] = (char) (0x80 | (c & 0x3F));
+
+            ++i;
+        }
+        else
+        if ((c < 0xD800) || (c > 0xDFFF))
+        {
+            dst[j++] = (char) (0xE0 | (c >> 12));
+            dst[j++] = (char) (0x80 | ((c >> 6) & 0x3F));
+            dst[j++] = (char) (0x80 | (c & 0x3F));
+
+            ++i;
+        }
+        else
+        {
+            if (c > 0xDBFF)
+                return { i, j, transcode_error_t::UnpairedSurrogate };
+
+            if (i + 1 == size)
+                return { i, j, transcode_error_t::Truncated };
+
+            const uint32_t d = src[i + 1];
+
+            if ((d < 0xDC00) || (d > 0xDFFF))
+                return { i, j, transcode_error_t::UnpairedSurrogate };
+
+            c = 0x10000 + ((c - 0xD800) << 10) + (d - 0xDC00);
+
+            dst[j++] = (char) (0xF0 | (c >> 18));
+            dst[j++] = (char) (0x80 | ((c >> 12) & 0x3F));
+            dst[j++] = (char) (0x80 | ((c >> 6) & 0x3F));
+            dst[j++] = (char) (0x80 | (c & 0x3F));
+
+            i += 2;
+        }
+    }
+
+    return { i, j, transcode_error_t::None };
+}
+
+/// <summary>
+/// Gets a description of a conversion error.
+/// </summary>
+const char * GetTranscodeErrorText(transcode_error_t error) noexcept
+{
+    switch (error)
+    {
+        case transcode_error_t::None:               return "no error";
+        case transcode_error_t::InvalidSequence:    return "invalid byte sequence";
+        case transcode_error_t::Truncated:          return "truncated sequence";
+        case transcode_error_t::UnpairedSurrogate:  return "unpaired surrogate";
+        default:                                    return "unknown error";
+    }
+}
@@ -0,0 +1,47 @@
+
+/** $VER: Transcoder.h (2026.10.17) P. Stuer - Converts between UTF-8 and UTF-16 in a single pass. **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// The reason a conversion stopped.
+/// </summary>
+enum class transcode_error_t : uint32_t
+{
+    None = 0,
+    InvalidSequence,        // A byte that can't start or continue a UTF-8 sequence, an overlong form, a surrogate or a value above U+10FFFF. For the legacy encodings, a byte sequence without a mapping.
+    Truncated,              // The input ends in the middle of a multi-byte sequence or a surrogate pair.
+    UnpairedSurrogate,      // A UTF-16 high surrogate not followed by a low surrogate, or a low surrogate on its own.
+};
+
+/// <summary>
+/// The outcome of a conversion. On error, Read is the offset of the first invalid code unit and Written the number of code units converted before it.
+/// </summary>
+struct transcode_result_t
+{
+    size_t Read;
+    size_t Written;
+    transcode_error_t Error;
+
+    bool IsValid() const noexcept { return Error == transcode_error_t::None; }
+};
+
+/// <summary>
+/// Gets the number of UTF-16 code units that is always large enough to hold the conversion of the specified number of UTF-8 bytes.
+/// </summary>
+constexpr size_t GetUTF16Capacity(size_t utf8Size) noexcept { return utf8Size; }
+
+/// <summary>
+/// Gets the number of UTF-8 bytes that is always large enough to hold the conversion of the specified number of UTF-16 code units.
+/// </summary>
+constexpr size_t GetUTF8Capacity(size_t utf16Size) noexcept { return utf16Size * 3; }
+
+size_t WidenASCII(const char * src, size_t size, char16_t * dst) noexcept;
+
+transcode_result_t UTF8ToUTF16(const char * src, size_t size, char16_t * dst) noexcept;
+transcode_result_t UTF16ToUTF8(const char16_t * src, size_t size, char * dst) noexcept;
+
+const char * GetTranscodeErrorText(transcode_error_t error) noexcept;
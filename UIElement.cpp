@@ -1,5 +1,5 @@
 
-/** $VER: UIElement.cpp (2024.06.12) P. Stuer **/
+/** $VER: UIElement.cpp (2026.10.17) P. Stuer **/
 
 #include "pch.h"
 
@@ -8,6 +8,11 @@
 #include "Encoding.h"
 #include "Exceptions.h"
 #include "Support.h"
+#include "TitleFormatCache.h"
+#include "CurrentTrack.h"
+#include "FormattedTextCache.h"
+#include "WebViewEnvironment.h"
+#include "Tracer.h"
 
 #include <pathcch.h>
 #pragma comment(lib, "pathcch")
@@ -22,9 +27,11 @@
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
-UIElement::UIElement() : m_bMsgHandled(FALSE)
+UIElement::UIElement() : m_bMsgHandled(FALSE), _EventQueue(*this)
 {
-    playlist_callback_single_impl_base::set_callback_flags(flag_on_item_focus_change);
+    playlist_callback_single_impl_base::set_callback_flags(flag_on_items_added | flag_on_items_reordered | flag_on_items_removed | flag_on_item_focus_change | flag_on_playlist_switch);
+
+    _SelectionType = ui_selection_manager::get()->get_selection_type();
 }
 
 #pragma region User Interface
@@ -34,31 +41,38 @@ UIElement::UIElement() : m_bMsgHandled(FALSE)
 /// </summary>
 LRESULT UIElement::OnCreate(LPCREATESTRUCT cs) noexcept
 {
+    trace_scope_t Scope("OnCreate", _TraceLane);
+
     _UIElementTracker.Add(this);
 
-    std::wstring WebViewVersion;
+    _Lifetime = std::make_shared<bool>(true);
 
-    if (!GetWebViewVersion(WebViewVersion))
-    {
-        console::printf(STR_COMPONENT_BASENAME " failed to find a compatible WebView component.");
+    std::wstring WebViewVersion;
 
+    if (!_WebViewEnvironment.GetVersion(WebViewVersion))
         return 1;
-    }
-
-    console::printf(STR_COMPONENT_BASENAME " is using WebView %s.", WideToUTF8(WebViewVersion).c_str());
 
     _HostObject = Microsoft::WRL::Make<HostObject>
     (
         [this](std::function<void (void)> callback)
         {
             RunAsync(callback);
-        }
+        },
+        [this](const std::vector<std::wstring> & texts)
+        {
+            RegisterFields(texts);
+        },
+        [this]()
+        {
+            return _Statistics.ToJSON(_EventQueue);
+        },
+        _Statistics,
+        _TraceLane
     );
 
     Initialize();
 
-    CreateWebView();
-
+    // The WebView is created the first time the panel becomes visible. Panels on tabs that are never opened only paint a placeholder.
     InitializeFileWatcher();
 
     return 0;
@@ -69,6 +83,19 @@ LRESULT UIElement::OnCreate(LPCREATESTRUCT cs) noexcept
 /// </summary>
 void UIElement::OnDestroy() noexcept
 {
+#ifdef _DEBUG
+    console::printf(STR_COMPONENT_BASENAME " received %llu events and executed %llu scripts.", _EventQueue.GetEventsReceived(), _EventQueue.GetScriptsExecuted());
+    console::printf(STR_COMPONENT_BASENAME " title format cache: %llu hits, %llu misses.", _TitleFormatCache.GetHits(), _TitleFormatCache.GetMisses());
+    console::printf(STR_COMPONENT_BASENAME " formatted text cache: %llu hits, %llu misses.", _FormattedTextCache.GetHits(), _FormattedTextCache.GetMisses());
+    console::printf(STR_COMPONENT_BASENAME " sent %llu field updates and suppressed %llu.", _Fields.GetFieldsSent(), _Fields.GetFieldsSuppressed());
+    console::printf(STR_COMPONENT_BASENAME " queued %llu tasks with %llu wakeups, %llu overflowed.", _TaskQueue.GetTasksQueued(), _TaskQueue.GetWakeups(), _TaskQueue.GetOverflows());
+#endif
+
+    _Lifetime.reset();
+
+    _EventQueue.Clear();
+    _TaskQueue.Clear();
+
     _FileWatcher.Stop();
 
     DeleteWebView();
@@ -93,6 +120,48 @@ void UIElement::OnSize(UINT type, CSize size) noexcept
     _Controller->put_Bounds(Bounds);
 }
 
+/// <summary>
+/// Handles the WM_SHOWWINDOW message.
+/// </summary>
+void UIElement::OnShowWindow(BOOL show, UINT status) noexcept
+{
+    SetWindowVisibility(show != FALSE);
+
+    SetMsgHandled(FALSE);
+}
+
+/// <summary>
+/// Handles the WM_TIMER message.
+/// </summary>
+void UIElement::OnTimer(UINT_PTR timerId) noexcept
+{
+    switch (timerId)
+    {
+        case FlushTimerId:
+        {
+            KillTimer(FlushTimerId);
+
+            RequestFlush();
+            break;
+        }
+
+        case RetryTimerId:
+        {
+            KillTimer(RetryTimerId);
+
+            DeleteWebView();
+
+            _IsWebViewRequested = false;
+
+            RequestWebView();
+            break;
+        }
+
+        default:
+            SetMsgHandled(FALSE);
+    }
+}
+
 /// <summary>
 /// Handles the WM_PAINT message.
 /// </summary>
@@ -120,6 +189,45 @@ void UIElement::OnPaint(CDCHandle dc) noexcept
         ::DrawTextW(ps.hdc, TEXT(STR_COMPONENT_NAME), -1, &cr, (UINT) Format);
 
     EndPaint(&ps);
+
+    RequestWebView();
+}
+
+/// <summary>
+/// Creates the WebView if it does not exist yet. Called when the panel becomes visible for the first time.
+/// </summary>
+void UIElement::RequestWebView() noexcept
+{
+    if (_IsWebViewRequested)
+        return;
+
+    _IsWebViewRequested = true;
+
+    try
+    {
+        CreateWebView();
+    }
+    catch (std::exception & e)
+    {
+        console::error(e.what());
+    }
+}
+
+/// <summary>
+/// Creates the WebView again after a delay that doubles with each failed attempt. Gives up after a few attempts until the panel is created again.
+/// </summary>
+void UIElement::RetryWebView() noexcept
+{
+    if (_CreationRetries >= MaxCreationRetries)
+    {
+        console::printf(STR_COMPONENT_BASENAME " gave up creating its WebView after %u attempts.", _CreationRetries + 1);
+
+        return;
+    }
+
+    SetTimer(RetryTimerId, 500u << _CreationRetries);
+
+    ++_CreationRetries;
 }
 
 /// <summary>
@@ -144,6 +252,8 @@ LRESULT UIElement::OnTemplateChanged(UINT msg, WPARAM wParam, LPARAM lParam) noe
 /// </summary>
 LRESULT UIElement::OnWebViewReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
 {
+    trace_scope_t Scope("UM_WEB_VIEW_READY", _TraceLane);
+
     try
     {
         SetWebViewVisibility(IsWebViewVisible()); // Work-around for WebView not appearing after foobar2000 starts while being hosted in a hidden tab.
@@ -165,6 +275,12 @@ void UIElement::OnConfigurationChanged() noexcept
 {
     _ExpandedTemplateFilePath = GetTemplateFilePath();
 
+    // The selection viewer preferences may have changed in the same Preferences session.
+    _SelectionType = ui_selection_manager::get()->get_selection_type();
+
+    _CurrentTrack.Invalidate();
+    _FormattedTextCache.Clear();
+
     try
     {
         InitializeFileWatcher();
@@ -177,40 +293,48 @@ void UIElement::OnConfigurationChanged() noexcept
 }
 
 /// <summary>
-/// Handles an async method call.
+/// Handles an async method call by running the tasks in the task queue.
 /// </summary>
 LRESULT UIElement::OnAsync(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
 {
-    auto * task = reinterpret_cast<std::function<void()>*>(wParam);
-
-    (*task)();
-
-    delete task;
+    _TaskQueue.Drain();
 
     return true;
 }
 
 /// <summary>
-/// Initializes the component.
+/// Sends the pending events to the template.
 /// </summary>
-void UIElement::Initialize()
+LRESULT UIElement::OnFlushEvents(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
 {
-    {
-        pfc::string8 Path = pfc::io::path::combine(core_api::get_profile_path(), STR_COMPONENT_BASENAME);
+    _IsFlushPending = false;
 
-        if (::_strnicmp(Path, "file://", 7) == 0)
-            Path = Path.subString(7);
+    if (_IsHidden)
+        return 0;
 
-        _UserDataFolderPath = ::UTF8ToWide(Path.c_str());
+    if (_IsFirstDispatchPending && !_EventQueue.IsEmpty())
+    {
+        _Tracer.Record("FirstDispatch", _TraceLane, _NavigationStart, tracer_t::Now());
 
-        if (!::PathFileExistsW(_UserDataFolderPath.c_str()))
-        {
-            // Create the user data directory.
-            if (!::CreateDirectoryW(_UserDataFolderPath.c_str(), nullptr))
-                console::printf(::GetErrorMessage(::GetLastError(), ::FormatText(STR_COMPONENT_BASENAME " failed to create user data folder \"%s\"", ::WideToUTF8(_UserDataFolderPath).c_str())).c_str());
-        }
+        _IsFirstDispatchPending = false;
     }
 
+    _EventQueue.Flush();
+
+    FlushFields();
+
+    FlushClock();
+
+    return 0;
+}
+
+/// <summary>
+/// Initializes the component.
+/// </summary>
+void UIElement::Initialize()
+{
+    _UserDataFolderPath = _WebViewEnvironment.GetUserDataFolderPath();
+
     {
         _ExpandedTemplateFilePath = GetTemplateFilePath();
 
@@ -270,6 +394,10 @@ void UIElement::InitializeWebView()
     if (_WebView == nullptr)
         return;
 
+    trace_scope_t Scope("Navigate", _TraceLane);
+
+    _NavigationStart = tracer_t::Now();
+
     // Navigate to the template.
     HRESULT hResult = _WebView->Navigate(_ExpandedTemplateFilePath.c_str());
 
@@ -279,8 +407,6 @@ void UIElement::InitializeWebView()
 
         throw Win32Exception(hResult, ::FormatText(STR_COMPONENT_BASENAME " failed to navigate to template \"%s\"", ::WideToUTF8(_ExpandedTemplateFilePath).c_str()));
     }
-
-    on_playback_new_track(nullptr);
 }
 
 /// <summary>
@@ -297,10 +423,50 @@ void UIElement::SetWebViewVisibility(bool visible) noexcept
     if (_Controller != nullptr)
         _Controller->put_Bounds(cr);
 
+    if (!visible)
+        InvalidateRect(nullptr, TRUE);
+
+    _IsWebViewVisible = visible;
+
+    UpdateVisibility();
+}
+
+/// <summary>
+/// Sets the visibility of the panel window e.g. when the tab that contains it gets selected or deselected.
+/// </summary>
+void UIElement::SetWindowVisibility(bool visible) noexcept
+{
+    _IsWindowVisible = visible;
+
     if (visible)
-        on_playback_new_track(nullptr); // Forces a refresh when the WebView becomes visible again e.g. after exiting Layout Edit mode.
+        RequestWebView();
+
+    UpdateVisibility();
+}
+
+/// <summary>
+/// Enters or leaves the hidden state. While hidden no events are sent to the page and the WebView is asked to use less memory.
+/// The WebView is only suspended when the window itself is hidden because it has to be made invisible first.
+/// </summary>
+void UIElement::UpdateVisibility() noexcept
+{
+    const bool IsHidden = !_IsWebViewVisible || !_IsWindowVisible;
+
+    if (IsHidden != _IsHidden)
+    {
+        _IsHidden = IsHidden;
+
+        (void) SetMemoryUsageTarget(IsHidden); // Ignore result.
+
+        // Sends the events, fields and clock anchor that were coalesced while the panel was hidden.
+        if (!IsHidden)
+            RequestFlush();
+    }
+
+    if (_IsWindowVisible)
+        ResumeWebView();
     else
-        InvalidateRect(nullptr, TRUE);
+        SuspendWebView();
 }
 
 /// <summary>
@@ -330,6 +496,14 @@ void UIElement::ShowPreferences() noexcept
     uc->show_preferences(_GUID);
 }
 
+/// <summary>
+/// Writes the statistics of this panel to the console.
+/// </summary>
+void UIElement::DumpStatistics() const noexcept
+{
+    console::printf(STR_COMPONENT_BASENAME " statistics:\n%s", _Statistics.ToText(_EventQueue).c_str());
+}
+
 /// <summary>
 /// Gets the window class definition.
 /// </summary>
@@ -358,236 +532,462 @@ CWndClassInfo & UIElement::GetWndClassInfo()
 
 #pragma endregion
 
-#pragma region play_callback_impl_base
-
 /// <summary>
-/// Called when playback is being initialized.
+/// Determines which callbacks the template implements. Only those will receive events.
 /// </summary>
-void UIElement::on_playback_starting(play_control::t_track_command command, bool paused)
+void UIElement::SubscribeCallbacks() noexcept
 {
     if (_WebView == nullptr)
         return;
 
-    const std::wstring FunctionName = OnPlaybackStartingCallback;
+    // The names must be in the same order as the event_type_t values.
+    static const std::wstring * CallbackNames[] =
+    {
+        &OnPlaybackStartingCallback,
+        &OnPlaybackNewTrackCallback,
+        &OnPlaybackStopCallback,
+        &OnPlaybackSeekCallback,
+        &OnPlaybackPauseCallback,
+        &OnPlaybackEditedCallback,
+        &OnPlaybackDynamicInfoCallback,
+        &OnPlaybackDynamicTrackInfoCallback,
+        &OnPlaybackTimeCallback,
+        &OnVolumeChangeCallback,
+        &OnPlaylistFocusedItemChangedCallback,
+    };
 
-    if (FunctionName.empty())
-        return;
+    static_assert(_countof(CallbackNames) == (size_t) event_type_t::Count, "Callback name table is out of sync with event_type_t");
 
-    static const wchar_t * CommandName = L"Unknown";
+    std::wstring Script = L"(() => { const Names = [";
 
-    if (command == play_control::t_track_command::track_command_play) CommandName = L"Play"; else
-    if (command == play_control::t_track_command::track_command_next) CommandName = L"Next"; else       // Plays the next track from the current playlist according to the current playback order.
-    if (command == play_control::t_track_command::track_command_prev) CommandName = L"Prev"; else       // Plays the previous track from the current playlist according to the current playback order.
-    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Random"; else     // Plays a random track from the current playlist.
+    for (size_t i = 0; i < _countof(CallbackNames); ++i)
+    {
+        if (i != 0)
+            Script.append(L", ");
 
-    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Set track"; else  // For internal use only, do not use.
-    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Resume";          // For internal use only, do not use.
+        Script.append(L"\"").append(*CallbackNames[i]).append(L"\"");
+    }
+
+    Script.append(L"]; let Mask = 0; Names.forEach((Name, i) => { if (eval('typeof ' + Name) === 'function') Mask |= (1 << i); }); return Mask; })();");
+
+    HRESULT hResult = _WebView->ExecuteScript(Script.c_str(), Callback<ICoreWebView2ExecuteScriptCompletedHandler>
+    (
+        [this, Lifetime = std::weak_ptr<bool>(_Lifetime), Start = tracer_t::Now()](HRESULT errorCode, LPCWSTR resultObjectAsJson) -> HRESULT
+        {
+            if (Lifetime.expired())
+                return S_OK;
+
+            _Tracer.Record("SubscribeCallbacks", _TraceLane, Start, tracer_t::Now());
+
+            // Fall back to sending every event if the template can't be inspected.
+            if (SUCCEEDED(errorCode) && (resultObjectAsJson != nullptr))
+                _EventQueue.SetSubscriptions((uint32_t) ::wcstoul(resultObjectAsJson, nullptr, 10));
+            else
+                _EventQueue.SetSubscriptions(event_queue_t::AllEvents);
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(\"%s\", %s)", FunctionName.c_str(), CommandName, (paused ? L"true" : L"false")).c_str(), nullptr);
+            SendPlaybackState();
+
+            return S_OK;
+        }
+    ).Get());
 
     if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_new_track() failed");
+    {
+        _EventQueue.SetSubscriptions(event_queue_t::AllEvents);
+
+        SendPlaybackState();
+    }
 }
 
 /// <summary>
-/// Called when playback advances to a new track.
+/// Sends the current playback state to a template that has just been loaded.
 /// </summary>
-void UIElement::on_playback_new_track(metadb_handle_ptr /*track*/)
+void UIElement::SendPlaybackState() noexcept
 {
-    if (_WebView == nullptr)
-        return;
+    on_playback_new_track(nullptr); // Forces the initial refresh of the template.
 
-    const std::wstring FunctionName = OnPlaybackNewTrackCallback;
+    auto PlaybackControl = playback_control::get();
 
-    if (FunctionName.empty())
-        return;
+    if (PlaybackControl->is_paused())
+        on_playback_pause(true);
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s()", FunctionName.c_str()).c_str(), nullptr);
+    on_volume_change(PlaybackControl->get_volume());
+}
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_new_track() failed");
+/// <summary>
+/// Registers the fields the template wants the host to push.
+/// </summary>
+void UIElement::RegisterFields(const std::vector<std::wstring> & texts) noexcept
+{
+    _Fields.Register(texts);
+
+    InvalidateFields(text_class_t::Static);
 }
 
 /// <summary>
-/// Called when playback stops.
+/// Marks the fields affected by an event of the specified class as out-of-date. They will be formatted and sent to the page during the next flush.
 /// </summary>
-void UIElement::on_playback_stop(play_control::t_stop_reason reason)
+void UIElement::InvalidateFields(text_class_t eventClass) noexcept
 {
-    if (_WebView == nullptr)
+    const uint32_t Classes = ::GetAffectedClasses(eventClass);
+
+    if ((_WebView == nullptr) || !_Fields.HasClasses(Classes))
         return;
 
-    const std::wstring FunctionName = OnPlaybackStopCallback;
+    _DirtyFieldClasses |= Classes;
+
+    RequestFlush();
+}
 
-    if (FunctionName.empty())
+/// <summary>
+/// Formats the fields and sends the ones that changed to the page in a single message.
+/// </summary>
+void UIElement::FlushFields() noexcept
+{
+    if ((_DirtyFieldClasses == 0) || (_WebView == nullptr))
         return;
 
-    static const wchar_t * Reason = L"unknown";
+    const uint32_t Classes = _DirtyFieldClasses;
 
-    if (reason == play_control::t_stop_reason::stop_reason_user)                Reason = L"User"; else
-    if (reason == play_control::t_stop_reason::stop_reason_eof)                 Reason = L"EOF"; else
-    if (reason == play_control::t_stop_reason::stop_reason_starting_another)    Reason = L"Starting another"; else
-    if (reason == play_control::t_stop_reason::stop_reason_shutting_down)       Reason = L"Shutting down";
+    _DirtyFieldClasses = 0;
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(\"%s\")", FunctionName.c_str(), Reason).c_str(), nullptr);
+    formatter_t Formatter;
+
+    const std::wstring Update = _Fields.GetUpdate(Formatter, Classes);
+
+    if (Update.empty())
+        return;
+
+    HRESULT hResult = _WebView->PostWebMessageAsJson(Update.c_str());
 
     if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_stop() failed");
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to send fields").c_str());
 }
 
 /// <summary>
-/// Called when the user seeks to a specific time.
+/// Marks the playback clock anchor as out-of-date. A new anchor will be sent to the page during the next flush.
 /// </summary>
-void UIElement::on_playback_seek(double time)
+void UIElement::InvalidateClock() noexcept
 {
     if (_WebView == nullptr)
         return;
 
-    const std::wstring FunctionName = OnPlaybackSeekCallback;
+    _IsClockDirty = true;
+
+    RequestFlush();
+}
 
-    if (FunctionName.empty())
+/// <summary>
+/// Sends a playback clock anchor to the page. The page extrapolates the playback position from it until the next anchor.
+/// The anchors are only sent when the playback position jumps or the playback rate changes (start, new track, seek, pause and stop).
+/// </summary>
+void UIElement::FlushClock() noexcept
+{
+    if (!_IsClockDirty || (_WebView == nullptr))
         return;
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(%f)", FunctionName.c_str(), time).c_str(), nullptr);
+    _IsClockDirty = false;
+
+    auto PlaybackControl = playback_control::get();
+
+    const bool IsPlaying = PlaybackControl->is_playing();
+    const bool IsPaused  = PlaybackControl->is_paused();
+
+    const double Position = IsPlaying ? PlaybackControl->playback_get_position() : 0.;
+    const double Length   = IsPlaying ? (std::max)(PlaybackControl->playback_get_length(), 0.) : 0.;
+
+    // The timestamp is expressed in milliseconds since the Unix epoch so the page can compare it with performance.timeOrigin + performance.now().
+    FILETIME ft;
+
+    ::GetSystemTimePreciseAsFileTime(&ft);
+
+    const double Timestamp = (double) ((((uint64_t) ft.dwHighDateTime << 32) | ft.dwLowDateTime) - 116444736000000000ull) / 10000.;
+
+    const std::wstring Anchor = ::FormatText(L"{\"type\":\"clock\",\"position\":%.6f,\"timestamp\":%.3f,\"length\":%.6f,\"playing\":%s,\"paused\":%s,\"rate\":%d}",
+        Position, Timestamp, Length, (IsPlaying ? L"true" : L"false"), (IsPaused ? L"true" : L"false"), ((IsPlaying && !IsPaused) ? 1 : 0));
+
+    HRESULT hResult = _WebView->PostWebMessageAsJson(Anchor.c_str());
 
     if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_seek() failed");
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to send clock anchor").c_str());
 }
 
+#pragma region event_sink_t
+
 /// <summary>
-/// Called when playback pauses or resumes.
+/// Schedules a flush of the event queue during the next turn of the message loop.
 /// </summary>
-void UIElement::on_playback_pause(bool paused)
+void UIElement::RequestFlush() noexcept
 {
-    if (_WebView == nullptr)
+    if (_IsFlushPending || _IsHidden)
         return;
 
-    const std::wstring FunctionName = OnPlaybackPauseCallback;
-
-    if (FunctionName.empty())
-        return;
+    _IsFlushPending = true;
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(%s)", FunctionName.c_str(), (paused ? L"true" : L"false")).c_str(), nullptr);
+    PostMessage(UM_FLUSH_EVENTS, 0, 0);
+}
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_pause() failed");
+/// <summary>
+/// Schedules a flush of the event queue after the specified delay.
+/// </summary>
+void UIElement::RequestDelayedFlush(uint32_t milliseconds) noexcept
+{
+    SetTimer(FlushTimerId, milliseconds);
 }
 
 /// <summary>
-/// Called when the currently played file gets edited.
+/// Executes a script generated by the event queue.
 /// </summary>
-void UIElement::on_playback_edited(metadb_handle_ptr hTrack)
+bool UIElement::ExecuteScript(const std::wstring & script, const std::vector<dispatched_event_t> & events, const script_ticket_t & ticket) noexcept
 {
     if (_WebView == nullptr)
-        return;
+        return false;
+
+    // Measures the time from the playback callbacks until the page has executed the script.
+    HRESULT hResult = _WebView->ExecuteScript(script.c_str(), Callback<ICoreWebView2ExecuteScriptCompletedHandler>
+    (
+        [this, Lifetime = std::weak_ptr<bool>(_Lifetime), Events = events, Ticket = ticket, Start = tracer_t::Now()](HRESULT errorCode, LPCWSTR) -> HRESULT
+        {
+            if (Lifetime.expired())
+                return S_OK;
 
-    const std::wstring FunctionName = OnPlaybackEditedCallback;
+            _Tracer.Record("ExecuteScript", _TraceLane, Start, tracer_t::Now());
 
-    if (FunctionName.empty())
-        return;
+            _EventQueue.OnScriptCompleted(Ticket);
+
+            _Statistics.RecordScript(SUCCEEDED(errorCode));
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s()", FunctionName.c_str()).c_str(), nullptr);
+            if (SUCCEEDED(errorCode))
+            {
+                const auto Now = _EventQueue.Now();
+
+                for (const auto & Event : Events)
+                    _Statistics.RecordEventLatency(Event.Type, statistics_t::GetElapsed(Event.Time, Now));
+            }
+
+            return S_OK;
+        }
+    ).Get());
 
     if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_edited() failed");
+    {
+        _Statistics.RecordScript(false);
+
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to execute script").c_str());
+
+        return false;
+    }
+
+    return true;
 }
 
+#pragma endregion
+
+#pragma region play_callback_impl_base
+
 /// <summary>
-/// Called when dynamic info (VBR bitrate etc...) changes.
+/// Called when playback is being initialized.
 /// </summary>
-void UIElement::on_playback_dynamic_info(const file_info & fileInfo)
+void UIElement::on_playback_starting(play_control::t_track_command command, bool paused)
 {
-    if (_WebView == nullptr)
-        return;
+    InvalidateClock();
 
-    const std::wstring FunctionName = OnPlaybackDynamicInfoCallback;
+    static const wchar_t * CommandName = L"Unknown";
 
-    if (FunctionName.empty())
-        return;
+    if (command == play_control::t_track_command::track_command_play) CommandName = L"Play"; else
+    if (command == play_control::t_track_command::track_command_next) CommandName = L"Next"; else       // Plays the next track from the current playlist according to the current playback order.
+    if (command == play_control::t_track_command::track_command_prev) CommandName = L"Prev"; else       // Plays the previous track from the current playlist according to the current playback order.
+    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Random"; else     // Plays a random track from the current playlist.
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s()", FunctionName.c_str()).c_str(), nullptr);
+    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Set track"; else  // For internal use only, do not use.
+    if (command == play_control::t_track_command::track_command_rand) CommandName = L"Resume";          // For internal use only, do not use.
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_dynamic_info() failed");
+    _EventQueue.Enqueue(event_type_t::PlaybackStarting, ::FormatText(L"%s(\"%s\", %s)", OnPlaybackStartingCallback.c_str(), CommandName, (paused ? L"true" : L"false")));
 }
 
 /// <summary>
-/// Called when the per-track dynamic info (stream track titles etc...) change. Happens less often than on_playback_dynamic_info().
+/// Called when playback advances to a new track.
 /// </summary>
-void UIElement::on_playback_dynamic_info_track(const file_info & fileInfo)
+void UIElement::on_playback_new_track(metadb_handle_ptr /*track*/)
 {
-    if (_WebView == nullptr)
-        return;
+    _CurrentTrack.Invalidate();
+    _FormattedTextCache.Invalidate(text_class_t::Static); // The results of the playing track include its dynamic info.
 
-    const std::wstring FunctionName = OnPlaybackDynamicTrackInfoCallback;
+    InvalidateClock();
+    InvalidateFields(text_class_t::Static);
 
-    if (FunctionName.empty())
-        return;
+    _EventQueue.Enqueue(event_type_t::PlaybackNewTrack, ::FormatText(L"%s()", OnPlaybackNewTrackCallback.c_str()));
+}
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s()", FunctionName.c_str()).c_str(), nullptr);
+/// <summary>
+/// Called when playback stops.
+/// </summary>
+void UIElement::on_playback_stop(play_control::t_stop_reason reason)
+{
+    _CurrentTrack.Invalidate();
+    _FormattedTextCache.Invalidate(text_class_t::Static); // The results of the playing track include its dynamic info.
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_dynamic_info_track() failed");
+    InvalidateClock();
+    InvalidateFields(text_class_t::Static);
+
+    static const wchar_t * Reason = L"unknown";
+
+    if (reason == play_control::t_stop_reason::stop_reason_user)                Reason = L"User"; else
+    if (reason == play_control::t_stop_reason::stop_reason_eof)                 Reason = L"EOF"; else
+    if (reason == play_control::t_stop_reason::stop_reason_starting_another)    Reason = L"Starting another"; else
+    if (reason == play_control::t_stop_reason::stop_reason_shutting_down)       Reason = L"Shutting down";
+
+    _EventQueue.Enqueue(event_type_t::PlaybackStop, ::FormatText(L"%s(\"%s\")", OnPlaybackStopCallback.c_str(), Reason));
 }
 
 /// <summary>
-/// Called, every second, for time display.
+/// Called when the user seeks to a specific time.
 /// </summary>
-void UIElement::on_playback_time(double time)
+void UIElement::on_playback_seek(double time)
 {
-    if (_WebView == nullptr)
-        return;
+    InvalidateClock();
+    InvalidateFields(text_class_t::Time);
 
-    const std::wstring FunctionName = OnPlaybackTimeCallback;
+    _EventQueue.Enqueue(event_type_t::PlaybackSeek, ::FormatText(L"%s(%f)", OnPlaybackSeekCallback.c_str(), time));
+}
 
-    if (FunctionName.empty())
-        return;
+/// <summary>
+/// Called when playback pauses or resumes.
+/// </summary>
+void UIElement::on_playback_pause(bool paused)
+{
+    InvalidateClock();
+    InvalidateFields(text_class_t::Time);
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(%f)", FunctionName.c_str(), time).c_str(), nullptr);
+    _EventQueue.Enqueue(event_type_t::PlaybackPause, ::FormatText(L"%s(%s)", OnPlaybackPauseCallback.c_str(), (paused ? L"true" : L"false")));
+}
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_playback_time failed()");
+/// <summary>
+/// Called when the currently played file gets edited.
+/// </summary>
+void UIElement::on_playback_edited(metadb_handle_ptr hTrack)
+{
+    _FormattedTextCache.Invalidate(hTrack);
+
+    InvalidateFields(text_class_t::Static);
+
+    _EventQueue.Enqueue(event_type_t::PlaybackEdited, ::FormatText(L"%s()", OnPlaybackEditedCallback.c_str()));
 }
 
 /// <summary>
-/// Called when the user changes the volume.
+/// Called when dynamic info (VBR bitrate etc...) changes.
 /// </summary>
-void UIElement::on_volume_change(float newValue) // in dBFS
+void UIElement::on_playback_dynamic_info(const file_info & fileInfo)
 {
-    if (_WebView == nullptr)
-        return;
+    _FormattedTextCache.Invalidate(text_class_t::DynamicInfo);
 
-    const std::wstring FunctionName = OnVolumeChangeCallback;
+    InvalidateFields(text_class_t::DynamicInfo);
 
-    if (FunctionName.empty())
-        return;
+    _EventQueue.Enqueue(event_type_t::PlaybackDynamicInfo, ::FormatText(L"%s()", OnPlaybackDynamicInfoCallback.c_str()));
+}
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s(%f)", FunctionName.c_str(), (double) newValue).c_str(), nullptr);
+/// <summary>
+/// Called when the per-track dynamic info (stream track titles etc...) change. Happens less often than on_playback_dynamic_info().
+/// </summary>
+void UIElement::on_playback_dynamic_info_track(const file_info & fileInfo)
+{
+    _FormattedTextCache.Invalidate(text_class_t::Static);
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_volume_change failed()");
+    InvalidateFields(text_class_t::Static);
+
+    _EventQueue.Enqueue(event_type_t::PlaybackDynamicTrackInfo, ::FormatText(L"%s()", OnPlaybackDynamicTrackInfoCallback.c_str()));
+}
+
+/// <summary>
+/// Called, every second, for time display.
+/// </summary>
+void UIElement::on_playback_time(double time)
+{
+    InvalidateFields(text_class_t::Time);
+
+    _EventQueue.Enqueue(event_type_t::PlaybackTime, ::FormatText(L"%s(%f)", OnPlaybackTimeCallback.c_str(), time));
+}
+
+/// <summary>
+/// Called when the user changes the volume.
+/// </summary>
+void UIElement::on_volume_change(float newValue) // in dBFS
+{
+    _EventQueue.Enqueue(event_type_t::VolumeChange, ::FormatText(L"%s(%f)", OnVolumeChangeCallback.c_str(), (double) newValue));
 }
 
 #pragma endregion
 
 #pragma region playlist_callback_single
 
+/// <summary>
+/// Called when items are added to the active playlist. The focused item may have moved.
+/// </summary>
+void UIElement::on_items_added(t_size, metadb_handle_list_cref, const bit_array &)
+{
+    _CurrentTrack.Invalidate();
+}
+
+/// <summary>
+/// Called when the items of the active playlist are reordered. The focused item may have moved.
+/// </summary>
+void UIElement::on_items_reordered(const t_size *, t_size)
+{
+    _CurrentTrack.Invalidate();
+}
+
+/// <summary>
+/// Called when items are removed from the active playlist. The focused item may have moved.
+/// </summary>
+void UIElement::on_items_removed(const bit_array &, t_size, t_size)
+{
+    _CurrentTrack.Invalidate();
+}
+
 /// <summary>
 /// Called when the selected item changes.
 /// </summary>
 void UIElement::on_item_focus_change(t_size fromIndex, t_size toIndex)
 {
-    if (_WebView == nullptr)
-        return;
+    _CurrentTrack.Invalidate();
+
+    InvalidateFields(text_class_t::Static);
+
+    _EventQueue.Enqueue(event_type_t::PlaylistFocusedItemChanged, ::FormatText(L"%s()", OnPlaylistFocusedItemChangedCallback.c_str()));
+}
 
-    const std::wstring FunctionName = OnPlaylistFocusedItemChangedCallback;
+/// <summary>
+/// Called when another playlist becomes the active playlist.
+/// </summary>
+void UIElement::on_playlist_switch()
+{
+    _CurrentTrack.Invalidate();
+
+    InvalidateFields(text_class_t::Static);
+}
 
-    if (FunctionName.empty())
+#pragma endregion
+
+#pragma region ui_selection_callback
+
+/// <summary>
+/// Called when the selection changes. The current track is resolved again if the type of the selection changed, e.g. because the user changes "Prefer current selection / playing track" in Preferences / Display / Selection viewers.
+/// </summary>
+void UIElement::on_selection_changed(metadb_handle_list_cref)
+{
+    const GUID SelectionType = ui_selection_manager::get()->get_selection_type();
+
+    if (SelectionType == _SelectionType)
         return;
 
-    HRESULT hResult = _WebView->ExecuteScript(::FormatText(L"%s()", FunctionName.c_str()).c_str(), nullptr);
+    _SelectionType = SelectionType;
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "on_item_focus_change failed()");
+    _CurrentTrack.Invalidate();
+    _FormattedTextCache.Clear();
+
+    InvalidateFields(text_class_t::Static);
+
+    _EventQueue.Enqueue(event_type_t::PlaylistFocusedItemChanged, ::FormatText(L"%s()", OnPlaylistFocusedItemChangedCallback.c_str()));
 }
 
 #pragma endregion
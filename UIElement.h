@@ -1,5 +1,5 @@
 
-/** $VER: UIElement.h (2024.06.12) P. Stuer **/
+/** $VER: UIElement.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
@@ -8,12 +8,18 @@
 #include "Resources.h"
 #include "FileWatcher.h"
 #include "Configuration.h"
+#include "EventQueue.h"
+#include "TaskQueue.h"
+#include "FieldSet.h"
+#include "Tracer.h"
+#include "Statistics.h"
 
 #include <SDK/cfg_var.h>
 #include <SDK/coreDarkMode.h>
 #include <SDK/playback_control.h>
 #include <SDK/play_callback.h>
 #include <SDK/playlist.h>
+#include <SDK/ui.h>
 #include <SDK/ui_element.h>
 
 #include <pfc/string_conv.h>
@@ -24,6 +30,8 @@
 
 #include <WebView2.h>
 
+#include <memory>
+
 #include "HostObjectImpl.h"
 
 using namespace Microsoft::WRL;
@@ -31,7 +39,7 @@ using namespace Microsoft::WRL;
 /// <summary>
 /// Implements the UIElement and Playback interface.
 /// </summary>
-class UIElement : public CWindowImpl<UIElement>, private play_callback_impl_base, private playlist_callback_single_impl_base
+class UIElement : public CWindowImpl<UIElement>, private play_callback_impl_base, private playlist_callback_single_impl_base, private ui_selection_callback_impl_base, private event_sink_t
 {
 public:
     UIElement();
@@ -49,6 +57,12 @@ public:
 
     static const UINT UM_WEB_VIEW_READY = WM_USER + 100;
     static const UINT UM_ASYNC          = WM_USER + 101;
+    static const UINT UM_FLUSH_EVENTS   = WM_USER + 102;
+
+    static const UINT_PTR FlushTimerId  = 1;
+    static const UINT_PTR RetryTimerId  = 2;
+
+    static const uint32_t MaxCreationRetries = 3;
 
     #pragma endregion
 
@@ -70,11 +84,16 @@ public:
 
     #pragma region HostObject
 
-    void RunAsync(std::function<void()> callback) noexcept
+    /// <summary>
+    /// Runs a task on the window thread during the next turn of the message loop. Can be called from any thread.
+    /// </summary>
+    template<typename F>
+    void RunAsync(F && task) noexcept
     {
-        auto * Task = new std::function<void()>(std::move(callback));
+        _TaskQueue.Push(std::forward<F>(task));
 
-        PostMessage(UM_ASYNC, reinterpret_cast<WPARAM>(Task), 0);
+        if (_TaskQueue.RequestWakeup())
+            PostMessage(UM_ASYNC, 0, 0);
     }
 
     void MessageBoxAsync(std::wstring message, std::wstring title)
@@ -121,6 +140,8 @@ protected:
 
     virtual void SetWebViewVisibility(bool visible) noexcept;
 
+    void SetWindowVisibility(bool visible) noexcept;
+
 private:
     #pragma region Playback callback methods
 
@@ -139,7 +160,25 @@ private:
 
     #pragma region playlist_callback_single
 
+    virtual void on_items_added(t_size startIndex, metadb_handle_list_cref items, const bit_array & selection) override;
+    virtual void on_items_reordered(const t_size * order, t_size count) override;
+    virtual void on_items_removed(const bit_array & mask, t_size oldCount, t_size newCount) override;
     virtual void on_item_focus_change(t_size fromIndex, t_size toIndex) override;
+    virtual void on_playlist_switch() override;
+
+    #pragma endregion
+
+    #pragma region ui_selection_callback
+
+    virtual void on_selection_changed(metadb_handle_list_cref selection) override;
+
+    #pragma endregion
+
+    #pragma region event_sink_t
+
+    void RequestFlush() noexcept override;
+    void RequestDelayedFlush(uint32_t milliseconds) noexcept override;
+    bool ExecuteScript(const std::wstring & script, const std::vector<dispatched_event_t> & events, const script_ticket_t & ticket) noexcept override;
 
     #pragma endregion
 
@@ -148,20 +187,26 @@ private:
     LRESULT OnCreate(LPCREATESTRUCT cs) noexcept;
     void OnDestroy() noexcept;
     void OnSize(UINT nType, CSize size) noexcept;
+    void OnShowWindow(BOOL show, UINT status) noexcept;
+    void OnTimer(UINT_PTR timerId) noexcept;
     void OnPaint(CDCHandle dc) noexcept;
     LRESULT OnTemplateChanged(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
     LRESULT OnWebViewReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
     LRESULT OnAsync(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    LRESULT OnFlushEvents(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
 
     BEGIN_MSG_MAP_EX(UIElement)
         MSG_WM_CREATE(OnCreate)
         MSG_WM_DESTROY(OnDestroy)
         MSG_WM_SIZE(OnSize)
+        MSG_WM_SHOWWINDOW(OnShowWindow)
+        MSG_WM_TIMER(OnTimer)
         MSG_WM_PAINT(OnPaint)
 
         MESSAGE_HANDLER_EX(UM_TEMPLATE_CHANGED, OnTemplateChanged)
         MESSAGE_HANDLER_EX(UM_WEB_VIEW_READY, OnWebViewReady)
         MESSAGE_HANDLER_EX(UM_ASYNC, OnAsync)
+        MESSAGE_HANDLER_EX(UM_FLUSH_EVENTS, OnFlushEvents)
     END_MSG_MAP()
 
     #pragma endregion
@@ -169,9 +214,15 @@ private:
     void Initialize();
 
 private:
-    bool GetWebViewVersion(std::wstring & versionInfo);
     void CreateWebView();
     void DeleteWebView() noexcept;
+    void RequestWebView() noexcept;
+    void RetryWebView() noexcept;
+
+    void UpdateVisibility() noexcept;
+    void SuspendWebView() noexcept;
+    void ResumeWebView() noexcept;
+    HRESULT SetMemoryUsageTarget(bool low) const noexcept;
 
     HRESULT CreateContextMenu(const wchar_t * itemLabel, const wchar_t * iconName) noexcept;
     HRESULT SetDarkMode(bool enabled) const noexcept;
@@ -179,9 +230,20 @@ private:
     void InitializeFileWatcher();
     void InitializeWebView();
 
+    void SubscribeCallbacks() noexcept;
+    void SendPlaybackState() noexcept;
+
+    void RegisterFields(const std::vector<std::wstring> & texts) noexcept;
+    void InvalidateFields(text_class_t eventClass) noexcept;
+    void FlushFields() noexcept;
+
+    void InvalidateClock() noexcept;
+    void FlushClock() noexcept;
+
     std::wstring GetTemplateFilePath() const noexcept;
 
     void ShowPreferences() noexcept;
+    void DumpStatistics() const noexcept;
 
     void OnConfigurationChanged() noexcept;
 
@@ -194,15 +256,46 @@ private:
     std::wstring _UserDataFolderPath;
     std::wstring _ExpandedTemplateFilePath;
 
+    pfc::hires_timer _CreationTimer;
+
+    GUID _SelectionType;                // The type of the selection when the current track was last checked. Changes with the "Prefer current selection / playing track" setting.
+
+    std::shared_ptr<bool> _Lifetime;    // Released when the window is destroyed. The WebView completion handlers hold a weak reference to it because they can run after the panel is gone.
+
+    const uint32_t _TraceLane = tracer_t::GetNextLane();
+    int64_t _NavigationStart = 0;
+    bool _IsFirstDispatchPending = false;
+
     wil::com_ptr<ICoreWebView2Environment> _Environment;
     wil::com_ptr<ICoreWebView2Controller> _Controller;
     wil::com_ptr<ICoreWebView2> _WebView;
     wil::com_ptr<ICoreWebView2ContextMenuItem> _ContextSubMenu;
 
     EventRegistrationToken _NavigationStartingToken = {};
+    EventRegistrationToken _NavigationCompletedToken = {};
     EventRegistrationToken _ContextMenuRequestedToken = {};
+    EventRegistrationToken _ProcessFailedToken = {};
+
+    uint32_t _CreationRetries = 0;  // The number of times the creation of the WebView failed since it last succeeded.
 
     wil::com_ptr<HostObject> _HostObject;
 
+    task_queue_t _TaskQueue;
+
+    event_queue_t _EventQueue;
+    statistics_t _Statistics;
+    bool _IsFlushPending = false;
+
+    field_set_t _Fields;
+    uint32_t _DirtyFieldClasses = 0;  // The classes of the fields that need to be re-evaluated during the next flush.
+
+    bool _IsClockDirty = false;
+
+    bool _IsWebViewRequested = false;
+    bool _IsWebViewVisible = true;  // False in Layout Edit mode.
+    bool _IsWindowVisible = true;   // False when the panel is on a hidden tab or minimized.
+    bool _IsHidden = false;         // True while no events are sent to the page. They are coalesced and sent when the panel becomes visible again.
+    bool _IsSuspended = false;
+
     FileWatcher _FileWatcher;
 };
@@ -10,7 +10,7 @@
 class uielement_tracker_t
 {
 public:
-    uielement_tracker_t() : _CurrentUIElement()
+    uielement_tracker_t() : _CurrentUIElement(), _PeakCount()
     {
     }
 
@@ -18,6 +18,8 @@ public:
     {
         _UIElements.push_back(element);
 
+        _PeakCount = (std::max)(_PeakCount, _UIElements.size());
+
         SetCurrentElement(element);
     }
 
@@ -33,6 +35,22 @@ public:
         }
     }
 
+    /// <summary>
+    /// Gets the number of panels that exist.
+    /// </summary>
+    size_t GetCount() const noexcept
+    {
+        return _UIElements.size();
+    }
+
+    /// <summary>
+    /// Gets the largest number of panels that existed at the same time during this session.
+    /// </summary>
+    size_t GetPeakCount() const noexcept
+    {
+        return _PeakCount;
+    }
+
     UIElement * GetCurrentElement() const noexcept
     {
         return _CurrentUIElement;
@@ -46,6 +64,7 @@ public:
 private:
     UIElement * _CurrentUIElement;
     std::vector<UIElement *> _UIElements;
+    size_t _PeakCount;
 };
 
 extern uielement_tracker_t _UIElementTracker;
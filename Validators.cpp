@@ -0,0 +1,749 @@
+
+/** $VER: Validators.cpp (2026.10.17) P. Stuer - Checks if a byte sequence is valid in a specific encoding. **/
+
+#include "Validators.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VALIDATORS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+    instruction_set_t DetectInstructionSet() noexcept;
+
+    instruction_set_t _SupportedInstructionSet = DetectInstructionSet();
+    instruction_set_t _InstructionSet = _SupportedInstructionSet;
+
+    /// <summary>
+    /// Gets the index of the lowest set bit of a non-zero mask.
+    /// </summary>
+    inline size_t CountTrailingZeros(uint32_t mask) noexcept
+    {
+    #ifdef _MSC_VER
+        unsigned long Index;
+
+        _BitScanForward(&Index, mask);
+
+        return Index;
+    #else
+        return (size_t) __builtin_ctz(mask);
+    #endif
+    }
+
+    #pragma region Scalar
+
+    /// <summary>
+    /// Gets the number of ASCII bytes at the start of the text, checking 8 bytes at a time.
+    /// </summary>
+    size_t SkipASCIIScalar(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t Word;
+
+            ::memcpy(&Word, data + i, sizeof(Word));
+
+            if ((Word & 0x8080808080808080ull) != 0)
+                break;
+        }
+
+        while ((i < size) && (data[i] < 0x80))
+            ++i;
+
+        return i;
+    }
+
+    /// <summary>
+    /// Validates UTF-8 according to the table of well-formed byte sequences of the Unicode Standard (Table 3-7): no stray continuation bytes, no overlong forms, no surrogates and nothing above U+10FFFF.
+    /// </summary>
+    template<size_t (*SkipASCII)(const uint8_t *, size_t)>
+    bool IsUTF8Scalar(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        while (i < size)
+        {
+            const uint8_t c = data[i];
+
+            if (c < 0x80)
+            {
+                i += SkipASCII(data + i, size - i);
+                continue;
+            }
+
+            size_t n;
+            uint8_t Lo = 0x80, Hi = 0xBF; // Range of the second byte
+
+            if ((c >= 0xC2) && (c <= 0xDF))
+                n = 1;
+            else
+            if ((c >= 0xE0) && (c <= 0xEF))
+            {
+                n = 2;
+
+                if (c == 0xE0) Lo = 0xA0; else  // Overlong
+                if (c == 0xED) Hi = 0x9F;       // U+D800 to U+DFFF
+            }
+            else
+            if ((c >= 0xF0) && (c <= 0xF4))
+            {
+                n = 3;
+
+                if (c == 0xF0) Lo = 0x90; else  // Overlong
+                if (c == 0xF4) Hi = 0x8F;       // Above U+10FFFF
+            }
+            else
+                return false; // Stray continuation byte, overlong 2-byte sequence (0xC0, 0xC1) or 0xF5 to 0xFF.
+
+            if (size - i <= n)
+                return false;
+
+            if ((data[i + 1] < Lo) || (data[i + 1] > Hi))
+                return false;
+
+            for (size_t j = 2; j <= n; ++j)
+            {
+                if ((data[i + j] & 0xC0) != 0x80)
+                    return false;
+            }
+
+            i += n + 1;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the number of bytes of the double-byte characters at the start of the text. The scalar validators check each character on their own.
+    /// </summary>
+    size_t SkipNoPairs(const uint8_t *, size_t) noexcept
+    {
+        return 0;
+    }
+
+    /// <summary>
+    /// Validates Shift-JIS (code page 932): ASCII, half-width katakana (0xA1 to 0xDF) or a lead byte (0x81 to 0x9F, 0xE0 to 0xFC) followed by a trail byte (0x40 to 0x7E, 0x80 to 0xFC). (http://www.rikai.com/library/kanjitables/kanji_codes.sjis.shtml)
+    /// </summary>
+    template<size_t (*SkipASCII)(const uint8_t *, size_t), size_t (*SkipPairs)(const uint8_t *, size_t)>
+    bool IsShiftJISScalar(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        while (i < size)
+        {
+            const uint8_t d1 = data[i];
+
+            if (d1 < 0x80)
+            {
+                i += SkipASCII(data + i, size - i);
+                continue;
+            }
+
+            if ((d1 >= 0xA1) && (d1 <= 0xDF))
+            {
+                ++i;
+                continue;
+            }
+
+            if (!((d1 >= 0x81 && d1 <= 0x9F) || (d1 >= 0xE0 && d1 <= 0xFC)))
+                return false;
+
+            const size_t n = SkipPairs(data + i, size - i);
+
+            if (n != 0)
+            {
+                i += n;
+                continue;
+            }
+
+            if (size - i < 2)
+                return false;
+
+            const uint8_t d2 = data[i + 1];
+
+            if (!((d2 >= 0x40 && d2 <= 0x7E) || (d2 >= 0x80 && d2 <= 0xFC)))
+                return false;
+
+            i += 2;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Validates EUC-JP: ASCII, a JIS X 0208 character (two bytes from 0xA1 to 0xFE), a half-width katakana (0x8E followed by 0xA1 to 0xDF) or a JIS X 0212 character (0x8F followed by two bytes from 0xA1 to 0xFE). (http://www.rikai.com/library/kanjitables/kanji_codes.euc.shtml)
+    /// </summary>
+    template<size_t (*SkipASCII)(const uint8_t *, size_t), size_t (*SkipPairs)(const uint8_t *, size_t)>
+    bool IsEUCJPScalar(const uint8_t * data, size_t size) noexcept
+    {
+        auto IsGraphic = [](uint8_t c) { return (c >= 0xA1) && (c <= 0xFE); };
+
+        size_t i = 0;
+
+        while (i < size)
+        {
+            const uint8_t d1 = data[i];
+
+            if (d1 < 0x80)
+            {
+                i += SkipASCII(data + i, size - i);
+                continue;
+            }
+
+            if (d1 == 0x8E)
+            {
+                if ((size - i < 2) || !((data[i + 1] >= 0xA1) && (data[i + 1] <= 0xDF)))
+                    return false;
+
+                i += 2;
+            }
+            else
+            if (d1 == 0x8F)
+            {
+                if ((size - i < 3) || !IsGraphic(data[i + 1]) || !IsGraphic(data[i + 2]))
+                    return false;
+
+                i += 3;
+            }
+            else
+            if (IsGraphic(d1))
+            {
+                const size_t n = SkipPairs(data + i, size - i);
+
+                if (n != 0)
+                {
+                    i += n;
+                    continue;
+                }
+
+                if ((size - i < 2) || !IsGraphic(data[i + 1]))
+                    return false;
+
+                i += 2;
+            }
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+    #pragma endregion
+
+#ifdef VALIDATORS_X86
+
+    #pragma region SSE2
+
+    /// <summary>
+    /// Gets the number of ASCII bytes at the start of the text, checking 16 bytes at a time.
+    /// </summary>
+    TARGET_SSE2 size_t SkipASCIISSE2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint32_t Mask = (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) (data + i)));
+
+            if (Mask != 0)
+                return i + CountTrailingZeros(Mask);
+        }
+
+        return i + SkipASCIIScalar(data + i, size - i);
+    }
+
+    /// <summary>
+    /// Returns 0xFF in each byte that lies between lo and hi (inclusive).
+    /// </summary>
+    TARGET_SSE2 inline __m128i IsInRangeSSE2(__m128i data, uint8_t lo, uint8_t hi) noexcept
+    {
+        return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(data, _mm_set1_epi8((char) lo)), data), _mm_cmpeq_epi8(_mm_min_epu8(data, _mm_set1_epi8((char) hi)), data));
+    }
+
+    /// <summary>
+    /// Gets the number of bytes of the Shift-JIS double-byte characters at the start of the text, checking 16 bytes at a time. The text must start at a character boundary.
+    /// A block is a run of 8 characters if the bytes at even positions are lead bytes and those at odd positions trail bytes.
+    /// </summary>
+    TARGET_SSE2 size_t SkipShiftJISPairsSSE2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i Data = _mm_loadu_si128((const __m128i *) (data + i));
+
+            const uint32_t Lead  = (uint32_t) _mm_movemask_epi8(_mm_or_si128(IsInRangeSSE2(Data, 0x81, 0x9F), IsInRangeSSE2(Data, 0xE0, 0xFC)));
+            const uint32_t Trail = (uint32_t) _mm_movemask_epi8(_mm_or_si128(IsInRangeSSE2(Data, 0x40, 0x7E), IsInRangeSSE2(Data, 0x80, 0xFC)));
+
+            const uint32_t IsValid = (Lead & 0x5555u) | (Trail & 0xAAAAu);
+
+            if (IsValid != 0xFFFFu)
+                return i + (CountTrailingZeros(~IsValid) & ~(size_t) 1);
+        }
+
+        return i;
+    }
+
+    /// <summary>
+    /// Gets the number of bytes of the EUC-JP JIS X 0208 characters at the start of the text, checking 16 bytes at a time. The text must start at a character boundary.
+    /// </summary>
+    TARGET_SSE2 size_t SkipEUCJPPairsSSE2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint32_t IsValid = (uint32_t) _mm_movemask_epi8(IsInRangeSSE2(_mm_loadu_si128((const __m128i *) (data + i)), 0xA1, 0xFE));
+
+            if (IsValid != 0xFFFFu)
+                return i + (CountTrailingZeros(~IsValid) & ~(size_t) 1);
+        }
+
+        return i;
+    }
+
+    #pragma endregion
+
+    #pragma region AVX2
+
+    /// <summary>
+    /// Gets the number of ASCII bytes at the start of the text, checking 32 bytes at a time.
+    /// </summary>
+    TARGET_AVX2 size_t SkipASCIIAVX2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+        {
+            const uint32_t Mask = (uint32_t) _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *) (data + i)));
+
+            if (Mask != 0)
+                return i + CountTrailingZeros(Mask);
+        }
+
+        return i + SkipASCIISSE2(data + i, size - i);
+    }
+
+    /// <summary>
+    /// Returns 0xFF in each byte that lies between lo and hi (inclusive).
+    /// </summary>
+    TARGET_AVX2 inline __m256i IsInRangeAVX2(__m256i data, uint8_t lo, uint8_t hi) noexcept
+    {
+        return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(data, _mm256_set1_epi8((char) lo)), data), _mm256_cmpeq_epi8(_mm256_min_epu8(data, _mm256_set1_epi8((char) hi)), data));
+    }
+
+    /// <summary>
+    /// Gets the number of bytes of the Shift-JIS double-byte characters at the start of the text, checking 32 bytes at a time. The text must start at a character boundary.
+    /// </summary>
+    TARGET_AVX2 size_t SkipShiftJISPairsAVX2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i Data = _mm256_loadu_si256((const __m256i *) (data + i));
+
+            const uint32_t Lead  = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(IsInRangeAVX2(Data, 0x81, 0x9F), IsInRangeAVX2(Data, 0xE0, 0xFC)));
+            const uint32_t Trail = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(IsInRangeAVX2(Data, 0x40, 0x7E), IsInRangeAVX2(Data, 0x80, 0xFC)));
+
+            const uint32_t IsValid = (Lead & 0x55555555u) | (Trail & 0xAAAAAAAAu);
+
+            if (IsValid != 0xFFFFFFFFu)
+                return i + (CountTrailingZeros(~IsValid) & ~(size_t) 1);
+        }
+
+        return i + SkipShiftJISPairsSSE2(data + i, size - i);
+    }
+
+    /// <summary>
+    /// Gets the number of bytes of the EUC-JP JIS X 0208 characters at the start of the text, checking 32 bytes at a time. The text must start at a character boundary.
+    /// </summary>
+    TARGET_AVX2 size_t SkipEUCJPPairsAVX2(const uint8_t * data, size_t size) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+        {
+            const uint32_t IsValid = (uint32_t) _mm256_movemask_epi8(IsInRangeAVX2(_mm256_loadu_si256((const __m256i *) (data + i)), 0xA1, 0xFE));
+
+            if (IsValid != 0xFFFFFFFFu)
+                return i + (CountTrailingZeros(~IsValid) & ~(size_t) 1);
+        }
+
+        return i + SkipEUCJPPairsSSE2(data + i, size - i);
+    }
+
+    /// <summary>
+    /// Validates UTF-8 32 bytes at a time using the lookup algorithm of J. Keiser and D. Lemire ("Validating UTF-8 In Less Than One Instruction Per Byte", 2021).
+    /// Each pair of adjacent bytes is classified with three 16-entry tables (high nibble of the first byte, low nibble of the first byte and high nibble of the second byte).
+    /// An error bit that survives the AND of the three classifications marks an invalid pair. The 3rd and 4th bytes of long sequences are checked separately.
+    /// </summary>
+    class utf8_validator_avx2_t
+    {
+    public:
+        TARGET_AVX2 utf8_validator_avx2_t() noexcept : _Error(_mm256_setzero_si256()), _Previous(_mm256_setzero_si256()), _PreviousIncomplete(_mm256_setzero_si256()) { }
+
+        TARGET_AVX2 void Check(__m256i input) noexcept
+        {
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                // An ASCII block is only an error if the previous block ended in the middle of a sequence.
+                _Error = _mm256_or_si256(_Error, _PreviousIncomplete);
+                _PreviousIncomplete = _mm256_setzero_si256();
+            }
+            else
+            {
+                const __m256i Prev1 = Shift<1>(input);
+
+                const __m256i SpecialCases = CheckSpecialCases(input, Prev1);
+
+                _Error = _mm256_or_si256(_Error, CheckMultiByteLengths(input, SpecialCases));
+                _PreviousIncomplete = IsIncomplete(input);
+            }
+
+            _Previous = input;
+        }
+
+        TARGET_AVX2 bool IsValid() const noexcept
+        {
+            const __m256i Error = _mm256_or_si256(_Error, _PreviousIncomplete);
+
+            return _mm256_testz_si256(Error, Error) != 0;
+        }
+
+    private:
+        enum : uint8_t
+        {
+            TooShort        = 1 << 0,   // A lead byte or ASCII character followed by a lead byte or ASCII character instead of a continuation byte.
+            TooLong         = 1 << 1,   // An ASCII character followed by a continuation byte.
+            Overlong3       = 1 << 2,   // 0xE0 followed by 0x80 to 0x9F
+            TooLarge        = 1 << 3,   // 0xF4 followed by 0x90 or higher, or 0xF5 to 0xFF followed by a continuation byte.
+            Surrogate       = 1 << 4,   // 0xED followed by 0xA0 to 0xBF
+            Overlong2       = 1 << 5,   // 0xC0 or 0xC1 followed by a continuation byte.
+            TooLarge1000    = 1 << 6,   // 0xF5 to 0xFF followed by 0x80 to 0x8F
+            Overlong4       = 1 << 6,   // 0xF0 followed by 0x80 to 0x8F
+            TwoContinuations= 1 << 7,   // A continuation byte followed by a continuation byte. Only an error if it's not the 3rd or 4th byte of a sequence.
+
+            Carry = TooShort | TooLong | TwoContinuations, // The errors that only depend on the high nibble of the first byte.
+        };
+
+        /// <summary>
+        /// Gets the input shifted right by n bytes, with the last bytes of the previous block shifted in.
+        /// </summary>
+        template<int N>
+        TARGET_AVX2 __m256i Shift(__m256i input) const noexcept
+        {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(_Previous, input, 0x21), 16 - N);
+        }
+
+        TARGET_AVX2 static __m256i Lookup(const uint8_t (&table)[16], __m256i index) noexcept
+        {
+            return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) table)), index);
+        }
+
+        TARGET_AVX2 static __m256i HighNibble(__m256i data) noexcept
+        {
+            return _mm256_and_si256(_mm256_srli_epi16(data, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        TARGET_AVX2 static __m256i CheckSpecialCases(__m256i input, __m256i prev1) noexcept
+        {
+            static const uint8_t Byte1High[16] =
+            {
+                TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,                 // 0_______ ASCII
+                TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,                 // 10______ Continuation
+                TooShort | Overlong2,                                                                   // 1100____
+                TooShort,                                                                               // 1101____
+                TooShort | Overlong3 | Surrogate,                                                       // 1110____
+                TooShort | TooLarge | TooLarge1000 | Overlong4,                                         // 1111____
+            };
+
+            static const uint8_t Byte1Low[16] =
+            {
+                Carry | Overlong3 | Overlong2 | Overlong4,                                              // ____0000
+                Carry | Overlong2,                                                                      // ____0001
+                Carry,                                                                                  // ____001_
+                Carry,
+                Carry | TooLarge,                                                                       // ____0100
+                Carry | TooLarge | TooLarge1000,                                                        // ____0101
+                Carry | TooLarge | TooLarge1000,                                                        // ____011_
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,                                                        // ____1___
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000 | Surrogate,                                            // ____1101
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+            };
+
+            static const uint8_t Byte2High[16] =
+            {
+                TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,         // 0_______ ASCII
+                TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,          // 1000____
+                TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,                          // 1001____
+                TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,                          // 101_____
+                TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+                TooShort, TooShort, TooShort, TooShort,                                                 // 11______ Lead byte
+            };
+
+            const __m256i B1H = Lookup(Byte1High, HighNibble(prev1));
+            const __m256i B1L = Lookup(Byte1Low,  _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+            const __m256i B2H = Lookup(Byte2High, HighNibble(input));
+
+            return _mm256_and_si256(_mm256_and_si256(B1H, B1L), B2H);
+        }
+
+        /// <summary>
+        /// Checks that the 3rd and 4th bytes of a sequence are continuation bytes. Two continuation bytes in a row are only valid in those positions.
+        /// </summary>
+        TARGET_AVX2 __m256i CheckMultiByteLengths(__m256i input, __m256i specialCases) const noexcept
+        {
+            const __m256i Prev2 = Shift<2>(input);
+            const __m256i Prev3 = Shift<3>(input);
+
+            const __m256i IsThirdByte  = _mm256_subs_epu8(Prev2, _mm256_set1_epi8((char) (0xE0 - 0x80))); // Only 111_____ results in 0x80 or higher.
+            const __m256i IsFourthByte = _mm256_subs_epu8(Prev3, _mm256_set1_epi8((char) (0xF0 - 0x80))); // Only 1111____ results in 0x80 or higher.
+
+            const __m256i MustBeContinuation = _mm256_and_si256(_mm256_or_si256(IsThirdByte, IsFourthByte), _mm256_set1_epi8((char) 0x80));
+
+            return _mm256_xor_si256(MustBeContinuation, specialCases);
+        }
+
+        /// <summary>
+        /// Returns a non-zero value if the block ends with the start of a sequence that continues in the next block.
+        /// </summary>
+        TARGET_AVX2 static __m256i IsIncomplete(__m256i input) noexcept
+        {
+            static const uint8_t MaxValue[32] =
+            {
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+            };
+
+            return _mm256_subs_epu8(input, _mm256_loadu_si256((const __m256i *) MaxValue));
+        }
+
+    private:
+        __m256i _Error;
+        __m256i _Previous;
+        __m256i _PreviousIncomplete;
+    };
+
+    TARGET_AVX2 bool IsUTF8AVX2(const uint8_t * data, size_t size) noexcept
+    {
+        utf8_validator_avx2_t Validator;
+
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+            Validator.Check(_mm256_loadu_si256((const __m256i *) (data + i)));
+
+        if (i < size)
+        {
+            uint8_t Tail[32] = { }; // Padded with ASCII.
+
+            ::memcpy(Tail, data + i, size - i);
+
+            Validator.Check(_mm256_loadu_si256((const __m256i *) Tail));
+        }
+
+        return Validator.IsValid();
+    }
+
+    #pragma endregion
+
+#endif
+
+    /// <summary>
+    /// Determines the best instruction set supported by the processor and the operating system.
+    /// </summary>
+    instruction_set_t DetectInstructionSet() noexcept
+    {
+    #if defined(VALIDATORS_X86)
+    #if defined(_MSC_VER)
+        int Info[4];
+
+        __cpuid(Info, 0);
+
+        const int MaxLeaf = Info[0];
+
+        __cpuid(Info, 1);
+
+        const bool HasSSE2    = (Info[3] & (1 << 26)) != 0;
+        const bool HasOSXSAVE = (Info[2] & (1 << 27)) != 0;
+        const bool HasAVX     = (Info[2] & (1 << 28)) != 0;
+
+        bool HasAVX2 = false;
+
+        // The OS must save the YMM registers on a context switch.
+        if ((MaxLeaf >= 7) && HasOSXSAVE && HasAVX && ((_xgetbv(0) & 0x06) == 0x06))
+        {
+            __cpuidex(Info, 7, 0);
+
+            HasAVX2 = (Info[1] & (1 << 5)) != 0;
+        }
+    #else
+        __builtin_cpu_init();
+
+        const bool HasSSE2 = __builtin_cpu_supports("sse2");
+        const bool HasAVX2 = __builtin_cpu_supports("avx2");
+    #endif
+
+        if (HasAVX2)
+            return instruction_set_t::AVX2;
+
+        if (HasSSE2)
+            return instruction_set_t::SSE2;
+    #endif
+
+        return instruction_set_t::Scalar;
+    }
+}
+
+/// <summary>
+/// Gets the instruction set used by the validators.
+/// </summary>
+instruction_set_t GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Overrides the instruction set used by the validators, e.g. to compare the implementations. Instruction sets that are not supported by the processor are ignored.
+/// </summary>
+void SetInstructionSet(instruction_set_t instructionSet) noexcept
+{
+    _InstructionSet = ((uint32_t) instructionSet <= (uint32_t) _SupportedInstructionSet) ? instructionSet : _SupportedInstructionSet;
+}
+
+/// <summary>
+/// Gets the name of an instruction set.
+/// </summary>
+const char * GetInstructionSetName(instruction_set_t instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case instruction_set_t::SSE2: return "SSE2";
+        case instruction_set_t::AVX2: return "AVX2";
+        default:                      return "Scalar";
+    }
+}
+
+/// <summary>
+/// Gets the number of ASCII bytes at the start of the specified text.
+/// </summary>
+size_t SkipASCII(const char * text, size_t size) noexcept
+{
+    const uint8_t * Data = (const uint8_t *) text;
+
+#ifdef VALIDATORS_X86
+    switch (_InstructionSet)
+    {
+        case instruction_set_t::AVX2: return SkipASCIIAVX2(Data, size);
+        case instruction_set_t::SSE2: return SkipASCIISSE2(Data, size);
+        default: break;
+    }
+#endif
+
+    return SkipASCIIScalar(Data, size);
+}
+
+/// <summary>
+/// Returns true if the specified text is ASCII encoded.
+/// </summary>
+bool IsASCII(const char * text, size_t size) noexcept
+{
+    return SkipASCII(text, size) == size;
+}
+
+/// <summary>
+/// Returns true if the specified text is UTF-8 encoded.
+/// </summary>
+bool IsUTF8(const char * text, size_t size) noexcept
+{
+    const uint8_t * Data = (const uint8_t *) text;
+
+#ifdef VALIDATORS_X86
+    switch (_InstructionSet)
+    {
+        case instruction_set_t::AVX2: return IsUTF8AVX2(Data, size);
+        case instruction_set_t::SSE2: return IsUTF8Scalar<SkipASCIISSE2>(Data, size);
+        default: break;
+    }
+#endif
+
+    return IsUTF8Scalar<SkipASCIIScalar>(Data, size);
+}
+
+/// <summary>
+/// Returns true if the specified text is Shift-JIS encoded.
+/// </summary>
+bool IsShiftJIS(const char * text, size_t size) noexcept
+{
+    const uint8_t * Data = (const uint8_t *) text;
+
+#ifdef VALIDATORS_X86
+    switch (_InstructionSet)
+    {
+        case instruction_set_t::AVX2: return IsShiftJISScalar<SkipASCIIAVX2, SkipShiftJISPairsAVX2>(Data, size);
+        case instruction_set_t::SSE2: return IsShiftJISScalar<SkipASCIISSE2, SkipShiftJISPairsSSE2>(Data, size);
+        default: break;
+    }
+#endif
+
+    return IsShiftJISScalar<SkipASCIIScalar, SkipNoPairs>(Data, size);
+}
+
+/// <summary>
+/// Returns true if the specified text is EUC-JP encoded.
+/// </summary>
+bool IsEUCJP(const char * text, size_t size) noexcept
+{
+    const uint8_t * Data = (const uint8_t *) text;
+
+#ifdef VALIDATORS_X86
+    switch (_InstructionSet)
+    {
+        case instruction_set_t::AVX2: return IsEUCJPScalar<SkipASCIIAVX2, SkipEUCJPPairsAVX2>(Data, size);
+        case instruction_set_t::SSE2: return IsEUCJPScalar<SkipASCIISSE2, SkipEUCJPPairsSSE2>(Data, size);
+        default: break;
+    }
+#endif
+
+    return IsEUCJPScalar<SkipASCIIScalar, SkipNoPairs>(Data, size);
+}
+
+#pragma region Scalar
+
+/// <summary>
+/// The reference implementations, independent of the processor.
+/// </summary>
+namespace scalar
+{
+    size_t SkipASCII(const char * text, size_t size) noexcept { return SkipASCIIScalar((const uint8_t *) text, size); }
+
+    bool IsASCII(const char * text, size_t size) noexcept { return SkipASCIIScalar((const uint8_t *) text, size) == size; }
+    bool IsUTF8(const char * text, size_t size) noexcept { return IsUTF8Scalar<SkipASCIIScalar>((const uint8_t *) text, size); }
+    bool IsShiftJIS(const char * text, size_t size) noexcept { return IsShiftJISScalar<SkipASCIIScalar, SkipNoPairs>((const uint8_t *) text, size); }
+    bool IsEUCJP(const char * text, size_t size) noexcept { return IsEUCJPScalar<SkipASCIIScalar, SkipNoPairs>((const uint8_t *) text, size); }
+}
+
+#pragma endregion
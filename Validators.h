@@ -0,0 +1,38 @@
+
+/** $VER: Validators.h (2026.10.17) P. Stuer - Checks if a byte sequence is valid in a specific encoding. **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// The instruction set used by the validators. Selected once at runtime.
+/// </summary>
+enum class instruction_set_t : uint32_t
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+};
+
+instruction_set_t GetInstructionSet() noexcept;
+void SetInstructionSet(instruction_set_t instructionSet) noexcept;
+const char * GetInstructionSetName(instruction_set_t instructionSet) noexcept;
+
+bool IsASCII(const char * text, size_t size) noexcept;
+bool IsUTF8(const char * text, size_t size) noexcept;
+bool IsShiftJIS(const char * text, size_t size) noexcept;
+bool IsEUCJP(const char * text, size_t size) noexcept;
+
+size_t SkipASCII(const char * text, size_t size) noexcept;
+
+namespace scalar
+{
+    bool IsASCII(const char * text, size_t size) noexcept;
+    bool IsUTF8(const char * text, size_t size) noexcept;
+    bool IsShiftJIS(const char * text, size_t size) noexcept;
+    bool IsEUCJP(const char * text, size_t size) noexcept;
+
+    size_t SkipASCII(const char * text, size_t size) noexcept;
+}
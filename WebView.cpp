@@ -1,10 +1,13 @@
 
-/** $VER: WebView.cpp (2024.06.12) P. Stuer - Creates the WebView. **/
+/** $VER: WebView.cpp (2026.10.17) P. Stuer - Creates the WebView. **/
 
 #include "pch.h"
 
 #include "UIElement.h"
+#include "UIElementTracker.h"
 #include "Exceptions.h"
+#include "WebViewEnvironment.h"
+#include "Tracer.h"
 
 #include <pfc/string-conv-lite.h>
 #include <pfc/pathUtils.h>
@@ -14,55 +17,222 @@ using namespace Microsoft::WRL;
 static HRESULT CreateIconStream(const wchar_t * resourceName, wil::com_ptr<IStream> & stream);
 
 /// <summary>
-/// Returns true if a supported WebView version is available on this system.
+/// Script that gets injected in every page. It registers the elements with a "data-tf" attribute as fields and applies the values pushed by the host.
+/// Templates can register additional texts with foo_vis_text.registerFields() and listen for the "foo_vis_text.fields" event.
+/// It also extrapolates the playback position from the clock anchors sent by the host and updates the elements with a "data-clock" attribute every animation frame.
 /// </summary>
-bool UIElement::GetWebViewVersion(std::wstring & versionString)
+static const wchar_t * const HelperScript = LR"JS(
+window.foo_vis_text = (() =>
 {
-    LPWSTR VersionString = nullptr;
+    const Texts = [];
+    const Indices = new Map();
+    const Elements = [];
+    let IsRegistrationPending = false;
 
-    HRESULT hResult = ::GetAvailableCoreWebView2BrowserVersionString(nullptr, &VersionString);
+    const Clock = { position: 0, timestamp: 0, length: 0, playing: false, paused: false, rate: 0 };
+    let ClockElements = [];
+    let AnimationFrame = 0;
 
-    if (!SUCCEEDED(hResult))
-        return false;
+    // Registers Title Formatting texts and returns their indices. All registrations made in the same task are sent to the host at once.
+    function registerFields(texts)
+    {
+        const Result = texts.map(Text =>
+        {
+            if (!Indices.has(Text))
+            {
+                Indices.set(Text, Texts.length);
+                Texts.push(Text);
+                Elements.push([]);
+            }
 
-    versionString = VersionString;
+            return Indices.get(Text);
+        });
 
-    ::CoTaskMemFree(VersionString);
+        if (!IsRegistrationPending)
+        {
+            IsRegistrationPending = true;
 
-    return true;
-}
+            queueMicrotask(() =>
+            {
+                IsRegistrationPending = false;
+
+                chrome.webview.hostObjects.foo_vis_text.RegisterFields(Texts.slice());
+            });
+        }
+
+        return Result;
+    }
+
+    // Returns the playback position in seconds, extrapolated from the last clock anchor.
+    function getPosition()
+    {
+        if (Clock.rate === 0)
+            return Clock.position;
+
+        const Position = Clock.position + (performance.timeOrigin + performance.now() - Clock.timestamp) / 1000 * Clock.rate;
+
+        return (Clock.length > 0) ? Math.min(Position, Clock.length) : Position;
+    }
+
+    function formatTime(seconds)
+    {
+        const s = Math.floor(Math.max(seconds, 0));
+
+        return Math.floor(s / 60) + ":" + String(s % 60).padStart(2, "0");
+    }
+
+    function setText(element, text)
+    {
+        if (element.textContent !== text)
+            element.textContent = text;
+    }
+
+    // Updates the elements with a "data-clock" attribute: "position" (default), "remaining", "length" or "progress".
+    function updateClockElements()
+    {
+        const Position = getPosition();
+
+        for (const Element of ClockElements)
+        {
+            switch (Element.dataset.clock)
+            {
+                case "remaining": setText(Element, (Clock.playing && Clock.length > 0) ? "-" + formatTime(Clock.length - Position) : ""); break;
+                case "length":    setText(Element, (Clock.playing && Clock.length > 0) ? formatTime(Clock.length) : ""); break;
+
+                case "progress":
+                {
+                    // <progress>, <meter> and <input type="range"> get a value; other elements get a "--progress" custom property between 0 and 1.
+                    if ((Element instanceof HTMLProgressElement) || (Element instanceof HTMLMeterElement) || (Element instanceof HTMLInputElement))
+                    {
+                        Element.max = Math.max(Clock.length, 0);
+                        Element.value = Math.min(Position, Element.max);
+                    }
+                    else
+                        Element.style.setProperty("--progress", (Clock.length > 0) ? Math.min(Position / Clock.length, 1) : 0);
+                    break;
+                }
+
+                default:          setText(Element, Clock.playing ? formatTime(Position) : "");
+            }
+        }
+
+        AnimationFrame = (Clock.rate !== 0) && (ClockElements.length > 0) ? requestAnimationFrame(updateClockElements) : 0;
+    }
+
+    function setClock(anchor)
+    {
+        Object.assign(Clock, anchor);
+
+        if (AnimationFrame !== 0)
+            cancelAnimationFrame(AnimationFrame);
+
+        updateClockElements();
+
+        document.dispatchEvent(new CustomEvent("foo_vis_text.clock", { detail: { ...Clock } }));
+    }
+
+    window.addEventListener("DOMContentLoaded", () =>
+    {
+        ClockElements = Array.from(document.querySelectorAll("[data-clock]"));
+
+        updateClockElements();
+
+        const Nodes = Array.from(document.querySelectorAll("[data-tf]"));
+
+        if (Nodes.length == 0)
+            return;
+
+        const NodeIndices = registerFields(Nodes.map(Node => Node.dataset.tf));
+
+        Nodes.forEach((Node, i) => Elements[NodeIndices[i]].push(Node));
+    });
+
+    chrome.webview.addEventListener("message", (event) =>
+    {
+        const Message = event.data;
+
+        if (Message?.type === "clock")
+        {
+            const { type, ...Anchor } = Message;
+
+            setClock(Anchor);
+            return;
+        }
+
+        if (Message?.type !== "fields")
+            return;
+
+        const Values = {};
+
+        for (const [Index, Value] of Object.entries(Message.values))
+        {
+            for (const Element of Elements[Index] ?? [])
+                Element.textContent = Value;
+
+            Values[Texts[Index]] = Value;
+        }
+
+        document.dispatchEvent(new CustomEvent("foo_vis_text.fields", { detail: Values }));
+    });
+
+    return { registerFields, clock: { position: getPosition, get length() { return Clock.length; }, get playing() { return Clock.playing; }, get paused() { return Clock.paused; } } };
+})();
+)JS";
 
 /// <summary>
 /// Creates the WebView.
 /// </summary>
 void UIElement::CreateWebView()
 {
-    HRESULT hResult = ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+    _CreationTimer.start();
 
-    if (!SUCCEEDED(hResult))
-        throw Win32Exception(hResult, "Failed to initialize COM");
+    const int64_t Start = tracer_t::Now();
 
-    hResult = ::CreateCoreWebView2EnvironmentWithOptions(nullptr, _UserDataFolderPath.c_str(), nullptr, Callback<ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler>
-    (
-        [this](HRESULT hResult, ICoreWebView2Environment * environment) -> HRESULT
+    HRESULT hResult = _WebViewEnvironment.Get(this,
+        [this, Start](HRESULT hResult, ICoreWebView2Environment * environment)
         {
-            UNREFERENCED_PARAMETER(hResult);
+            _Tracer.Record("EnvironmentCompleted", _TraceLane, Start, tracer_t::Now());
+
+            if (!SUCCEEDED(hResult))
+                return;
 
             _Environment = environment;
 
             // Create a CoreWebView2Controller and get the associated CoreWebView2 whose parent is the main window.
             environment->CreateCoreWebView2Controller(m_hWnd, Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>
             (
-                [this](HRESULT hResult, ICoreWebView2Controller * controller) -> HRESULT
+                [this, Lifetime = std::weak_ptr<bool>(_Lifetime), Start](HRESULT hResult, ICoreWebView2Controller * controller) -> HRESULT
                 {
-                    if (controller != nullptr)
+                    // The panel may have been destroyed while the controller was being created.
+                    if (Lifetime.expired())
                     {
-                        _Controller = controller;
-                        _Controller->get_CoreWebView2(&_WebView);
+                        if (controller != nullptr)
+                            controller->Close();
 
-                        _Controller->put_IsVisible(TRUE);
+                        return S_OK;
                     }
 
+                    _Tracer.Record("ControllerCompleted", _TraceLane, Start, tracer_t::Now());
+
+                    if (!SUCCEEDED(hResult) || (controller == nullptr))
+                    {
+                        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to create WebView controller").c_str());
+
+                        // The environment is shared with the other panels. It is only released when its browser process exits (see ProcessFailed below).
+                        RetryWebView();
+
+                        return S_OK;
+                    }
+
+                    _CreationRetries = 0;
+
+                    _Controller = controller;
+                    _Controller->get_CoreWebView2(&_WebView);
+
+                    _Controller->put_IsVisible(TRUE);
+
+                    console::printf(STR_COMPONENT_BASENAME " created its WebView in %.1f ms, %.1f ms after startup (%u panels).", _CreationTimer.query() * 1000., _WebViewEnvironment.GetTimeSinceStartup(), (uint32_t) _UIElementTracker.GetCount());
+
                     (void) SetDarkMode(_DarkMode); // Ignore result.
 
                     // Add a few settings.
@@ -79,6 +249,9 @@ void UIElement::CreateWebView()
                         }
                     }
 
+                    // Inject the script that receives the fields pushed by the host.
+                    (void) _WebView->AddScriptToExecuteOnDocumentCreated(HelperScript, nullptr);
+
                     // Resize WebView to fit the bounds of the parent window.
                     {
                         RECT Bounds;
@@ -104,6 +277,13 @@ void UIElement::CreateWebView()
                         (
                             [this](ICoreWebView2 * webView, ICoreWebView2NavigationStartingEventArgs * args) -> HRESULT
                             {
+                                // Hold the events until we know which callbacks the new page implements.
+                                _EventQueue.Hold();
+
+                                _Fields.Clear();
+                                _DirtyFieldClasses = 0;
+                                _IsClockDirty = false;
+
                                 VARIANT RemoteObject = {};
 
                                 _HostObject.query_to<IDispatch>(&RemoteObject.pdispVal);
@@ -121,6 +301,52 @@ void UIElement::CreateWebView()
                         ).Get(), &_NavigationStartingToken);
                     }
 
+                    // Add an event handler to determine which callbacks the template implements once the page has been loaded.
+                    {
+                        _WebView->add_NavigationCompleted(Microsoft::WRL::Callback<ICoreWebView2NavigationCompletedEventHandler>
+                        (
+                            [this](ICoreWebView2 * webView, ICoreWebView2NavigationCompletedEventArgs * args) -> HRESULT
+                            {
+                                _Tracer.Record("NavigationCompleted", _TraceLane, _NavigationStart, tracer_t::Now());
+
+                                _IsFirstDispatchPending = _Tracer.IsEnabled();
+
+                                SubscribeCallbacks();
+
+                                return S_OK;
+                            }
+                        ).Get(), &_NavigationCompletedToken);
+                    }
+
+                    // Add an event handler to recreate the WebView when its browser process exits. The dead environment is released once for all panels.
+                    {
+                        _WebView->add_ProcessFailed(Microsoft::WRL::Callback<ICoreWebView2ProcessFailedEventHandler>
+                        (
+                            [this](ICoreWebView2 * webView, ICoreWebView2ProcessFailedEventArgs * args) -> HRESULT
+                            {
+                                COREWEBVIEW2_PROCESS_FAILED_KIND Kind;
+
+                                HRESULT hr = args->get_ProcessFailedKind(&Kind);
+
+                                if (!SUCCEEDED(hr))
+                                    return hr;
+
+                                if (Kind != COREWEBVIEW2_PROCESS_FAILED_KIND_BROWSER_PROCESS_EXITED)
+                                    return S_OK;
+
+                                console::printf(STR_COMPONENT_BASENAME " lost its WebView browser process and creates a new one.");
+
+                                _WebViewEnvironment.OnBrowserProcessExited(_Environment.get());
+
+                                _Environment = nullptr;
+
+                                RetryWebView();
+
+                                return S_OK;
+                            }
+                        ).Get(), &_ProcessFailedToken);
+                    }
+
                     // Add custom context menu items.
                     {
                         wil::com_ptr<ICoreWebView2_11> WebView2_11 = _WebView.try_query<ICoreWebView2_11>();
@@ -182,10 +408,8 @@ void UIElement::CreateWebView()
                     return S_OK;
                 }
             ).Get());
-
-            return S_OK;
         }
-    ).Get());
+    );
 
     if (!SUCCEEDED(hResult))
         throw Win32Exception(hResult, "Failed to create WebView");
@@ -196,16 +420,97 @@ void UIElement::CreateWebView()
 /// </summary>
 void UIElement::DeleteWebView() noexcept
 {
+    _WebViewEnvironment.Cancel(this);
+
     if (_WebView)
     {
         _WebView->RemoveHostObjectFromScript(TEXT(STR_COMPONENT_BASENAME));
 
         _WebView->remove_NavigationStarting(_NavigationStartingToken);
+        _WebView->remove_NavigationCompleted(_NavigationCompletedToken);
+        _WebView->remove_ProcessFailed(_ProcessFailedToken);
 
         _WebView = nullptr;
     }
 
-    _Controller = nullptr;
+    // Close the controller explicitly: releasing it doesn't close the WebView while the browser still holds references to it, e.g. in pending completion handlers.
+    if (_Controller)
+    {
+        _Controller->Close();
+
+        _Controller = nullptr;
+    }
+
+    _EventQueue.Hold();
+
+    _IsSuspended = false;
+}
+
+/// <summary>
+/// Hides the WebView and asks it to suspend itself.
+/// </summary>
+void UIElement::SuspendWebView() noexcept
+{
+    if ((_Controller == nullptr) || _IsSuspended)
+        return;
+
+    wil::com_ptr<ICoreWebView2_3> WebView2_3 = _WebView.try_query<ICoreWebView2_3>();
+
+    if (WebView2_3 == nullptr)
+        return;
+
+    // TrySuspend() fails if the WebView is visible.
+    _Controller->put_IsVisible(FALSE);
+
+    HRESULT hResult = WebView2_3->TrySuspend(Callback<ICoreWebView2TrySuspendCompletedHandler>
+    (
+        [](HRESULT hResult, BOOL isSuccessful) -> HRESULT
+        {
+        #ifdef _DEBUG
+            console::printf(STR_COMPONENT_BASENAME " %s the WebView.", (SUCCEEDED(hResult) && isSuccessful) ? "suspended" : "failed to suspend");
+        #endif
+            return S_OK;
+        }
+    ).Get());
+
+    if (!SUCCEEDED(hResult))
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to suspend WebView").c_str());
+
+    _IsSuspended = true;
+}
+
+/// <summary>
+/// Resumes and shows a suspended WebView.
+/// </summary>
+void UIElement::ResumeWebView() noexcept
+{
+    if ((_Controller == nullptr) || !_IsSuspended)
+        return;
+
+    _IsSuspended = false;
+
+    wil::com_ptr<ICoreWebView2_3> WebView2_3 = _WebView.try_query<ICoreWebView2_3>();
+
+    if (WebView2_3 != nullptr)
+        WebView2_3->Resume();
+
+    _Controller->put_IsVisible(TRUE);
+}
+
+/// <summary>
+/// Lowers or restores the memory usage target of the WebView.
+/// </summary>
+HRESULT UIElement::SetMemoryUsageTarget(bool low) const noexcept
+{
+    if (_WebView == nullptr)
+        return E_ILLEGAL_METHOD_CALL;
+
+    wil::com_ptr<ICoreWebView2_19> WebView2_19 = _WebView.try_query<ICoreWebView2_19>();
+
+    if (WebView2_19 == nullptr)
+        return E_NOINTERFACE;
+
+    return WebView2_19->put_MemoryUsageTargetLevel(low ? COREWEBVIEW2_MEMORY_USAGE_TARGET_LEVEL_LOW : COREWEBVIEW2_MEMORY_USAGE_TARGET_LEVEL_NORMAL);
 }
 
 /// <summary>
@@ -291,6 +596,32 @@ HRESULT UIElement::CreateContextMenu(const wchar_t * itemLabel, const wchar_t *
         }
 
         hr = Children->InsertValueAtIndex(0, ContextMenuItem.get());
+
+        if (!SUCCEEDED(hr))
+            return hr;
+
+        // Creates a menu item that writes the statistics of the panel to the console.
+        {
+            hr = Environment9->CreateContextMenuItem(L"Dump statistics to console", nullptr, COREWEBVIEW2_CONTEXT_MENU_ITEM_KIND_COMMAND, &ContextMenuItem);
+
+            if (!SUCCEEDED(hr))
+                return hr;
+
+            hr = ContextMenuItem->add_CustomItemSelected(Callback<ICoreWebView2CustomItemSelectedEventHandler>
+            (
+                [this](ICoreWebView2ContextMenuItem * sender, IUnknown * args)
+                {
+                    RunAsync([this] { DumpStatistics(); });
+
+                    return S_OK;
+                }
+            ).Get(), nullptr);
+
+            if (!SUCCEEDED(hr))
+                return hr;
+        }
+
+        hr = Children->InsertValueAtIndex(1, ContextMenuItem.get());
     }
 
     return hr;
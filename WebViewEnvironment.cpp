@@ -0,0 +1,241 @@
+
+/** $VER: WebViewEnvironment.cpp (2026.10.17) P. Stuer - Shares one WebView environment between all instances of the panel. **/
+
+#include "pch.h"
+
+#include "WebViewEnvironment.h"
+#include "Configuration.h"
+#include "UIElementTracker.h"
+#include "Exceptions.h"
+#include "Resources.h"
+#include "Encoding.h"
+#include "Tracer.h"
+
+#include <SDK/initquit.h>
+
+#include <pfc/pathUtils.h>
+
+#include <shlwapi.h>
+
+#include <wrl.h>
+
+#pragma hdrstop
+
+using namespace Microsoft::WRL;
+
+/// <summary>
+/// Gets the environment. The callback is called immediately if the environment already exists; otherwise it is called once the environment has been created.
+/// All instances use the same user data folder so they can share the browser process.
+/// </summary>
+HRESULT webview_environment_t::Get(const void * owner, callback_t callback) noexcept
+{
+    if (_State == state_t::Ready)
+    {
+        callback(_Result, _Environment.get());
+
+        return S_OK;
+    }
+
+    _Callbacks.push_back({ owner, std::move(callback) });
+
+    if (_State == state_t::Creating)
+        return S_OK;
+
+    HRESULT hResult = ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+
+    if (!SUCCEEDED(hResult))
+    {
+        _Callbacks.pop_back();
+
+        return hResult;
+    }
+
+    _State = state_t::Creating;
+    _CreationStart = tracer_t::Now();
+
+    hResult = ::CreateCoreWebView2EnvironmentWithOptions(nullptr, GetUserDataFolderPath().c_str(), nullptr, Callback<ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler>
+    (
+        [this](HRESULT hResult, ICoreWebView2Environment * environment) -> HRESULT
+        {
+            OnCreated(hResult, environment);
+
+            return S_OK;
+        }
+    ).Get());
+
+    if (!SUCCEEDED(hResult))
+    {
+        _State = state_t::Idle;
+        _Callbacks.clear();
+    }
+
+    return hResult;
+}
+
+/// <summary>
+/// Removes the pending callbacks of an instance that is being destroyed.
+/// </summary>
+void webview_environment_t::Cancel(const void * owner) noexcept
+{
+    _Callbacks.erase(std::remove_if(_Callbacks.begin(), _Callbacks.end(), [owner](const auto & item) { return item.first == owner; }), _Callbacks.end());
+}
+
+/// <summary>
+/// Releases the environment. The next request creates a new one.
+/// </summary>
+void webview_environment_t::Reset() noexcept
+{
+    if (_State == state_t::Creating)
+        return;
+
+    _Environment = nullptr;
+    _Result = S_OK;
+
+    _State = state_t::Idle;
+}
+
+/// <summary>
+/// Releases the specified environment because its browser process exited. Every panel that used it reports the exit;
+/// the environment is only released once so that the new one created by the first panel is not dropped by the others.
+/// </summary>
+void webview_environment_t::OnBrowserProcessExited(const ICoreWebView2Environment * environment) noexcept
+{
+    if ((_State == state_t::Ready) && (_Environment.get() == environment))
+        Reset();
+}
+
+/// <summary>
+/// Starts creating the environment before any panel needs it.
+/// </summary>
+void webview_environment_t::Prewarm() noexcept
+{
+    std::wstring Version;
+
+    if (!GetVersion(Version))
+        return;
+
+    HRESULT hResult = Get(nullptr, [](HRESULT, ICoreWebView2Environment *) { });
+
+    if (!SUCCEEDED(hResult))
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to prewarm WebView environment").c_str());
+}
+
+/// <summary>
+/// Returns true if a supported WebView version is available on this system. The result is determined only once.
+/// </summary>
+bool webview_environment_t::GetVersion(std::wstring & version) noexcept
+{
+    if (!_IsVersionKnown)
+    {
+        LPWSTR VersionString = nullptr;
+
+        HRESULT hResult = ::GetAvailableCoreWebView2BrowserVersionString(nullptr, &VersionString);
+
+        _IsVersionAvailable = SUCCEEDED(hResult) && (VersionString != nullptr);
+
+        if (_IsVersionAvailable)
+        {
+            _Version = VersionString;
+
+            console::printf(STR_COMPONENT_BASENAME " is using WebView %s.", ::WideToUTF8(_Version).c_str());
+        }
+        else
+            console::printf(STR_COMPONENT_BASENAME " failed to find a compatible WebView component.");
+
+        ::CoTaskMemFree(VersionString);
+
+        _IsVersionKnown = true;
+    }
+
+    version = _Version;
+
+    return _IsVersionAvailable;
+}
+
+/// <summary>
+/// Gets the path of the user data folder, creating the folder if necessary.
+/// </summary>
+const std::wstring & webview_environment_t::GetUserDataFolderPath() noexcept
+{
+    if (!_UserDataFolderPath.empty())
+        return _UserDataFolderPath;
+
+    pfc::string8 Path = pfc::io::path::combine(core_api::get_profile_path(), STR_COMPONENT_BASENAME);
+
+    if (::_strnicmp(Path, "file://", 7) == 0)
+        Path = Path.subString(7);
+
+    _UserDataFolderPath = ::UTF8ToWide(Path.c_str());
+
+    if (!::PathFileExistsW(_UserDataFolderPath.c_str()))
+    {
+        // Create the user data directory.
+        if (!::CreateDirectoryW(_UserDataFolderPath.c_str(), nullptr))
+            console::printf(::GetErrorMessage(::GetLastError(), ::FormatText(STR_COMPONENT_BASENAME " failed to create user data folder \"%s\"", ::WideToUTF8(_UserDataFolderPath).c_str())).c_str());
+    }
+
+    return _UserDataFolderPath;
+}
+
+/// <summary>
+/// Hands the new environment to all waiting instances.
+/// </summary>
+void webview_environment_t::OnCreated(HRESULT hResult, ICoreWebView2Environment * environment) noexcept
+{
+    _Tracer.Record("CreateEnvironment", tracer_t::ProcessLane, _CreationStart, tracer_t::Now());
+
+    if (SUCCEEDED(hResult) && (environment == nullptr))
+        hResult = E_POINTER;
+
+    if (SUCCEEDED(hResult))
+    {
+        _Environment = environment;
+        _Result = S_OK;
+
+        _State = state_t::Ready;
+    }
+    else
+    {
+        console::printf(::GetErrorMessage((DWORD) hResult, STR_COMPONENT_BASENAME " failed to create WebView environment").c_str());
+
+        _State = state_t::Idle; // Allow the next instance to try again.
+    }
+
+    // The callbacks may add or cancel requests.
+    auto Callbacks = std::move(_Callbacks);
+
+    _Callbacks.clear();
+
+    for (auto & [Owner, Callback] : Callbacks)
+        Callback(hResult, environment);
+}
+
+webview_environment_t _WebViewEnvironment;
+
+namespace
+{
+    /// <summary>
+    /// Prewarms the shared environment when foobar2000 initializes and releases it before COM shuts down.
+    /// The number of panels is remembered at shutdown so no browser process is started for a layout without panels.
+    /// </summary>
+    class webview_environment_initquit_t : public initquit
+    {
+    public:
+        void on_init() noexcept override
+        {
+            _WebViewEnvironment.SetStartupTime();
+
+            if (PanelCountCfg > 0)
+                _WebViewEnvironment.Prewarm();
+        }
+
+        void on_quit() noexcept override
+        {
+            PanelCountCfg = (int) _UIElementTracker.GetPeakCount();
+
+            _WebViewEnvironment.Reset();
+        }
+    };
+
+    static initquit_factory_t<webview_environment_initquit_t> _InitQuitFactory;
+}
@@ -0,0 +1,81 @@
+
+/** $VER: WebViewEnvironment.h (2026.10.17) P. Stuer - Shares one WebView environment between all instances of the panel. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <wil/com.h>
+
+#include <WebView2.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Creates the WebView environment once and hands it to every instance of the panel. Must be used from the main thread.
+/// The environment is prewarmed when foobar2000 initializes so the first panel does not have to wait for it, but only if the last session had at least one panel.
+/// </summary>
+class webview_environment_t
+{
+public:
+    typedef std::function<void(HRESULT hResult, ICoreWebView2Environment * environment)> callback_t;
+
+    webview_environment_t() noexcept : _State(state_t::Idle), _Result(S_OK), _CreationStart(), _StartupTime(std::chrono::steady_clock::now()), _IsVersionKnown(), _IsVersionAvailable() { }
+
+    webview_environment_t(const webview_environment_t &) = delete;
+    webview_environment_t & operator=(const webview_environment_t &) = delete;
+    webview_environment_t(webview_environment_t &&) = delete;
+    webview_environment_t & operator=(webview_environment_t &&) = delete;
+
+    HRESULT Get(const void * owner, callback_t callback) noexcept;
+    void Cancel(const void * owner) noexcept;
+    void Reset() noexcept;
+    void OnBrowserProcessExited(const ICoreWebView2Environment * environment) noexcept;
+
+    void Prewarm() noexcept;
+
+    /// <summary>
+    /// Gets the time in milliseconds since foobar2000 initialized the component.
+    /// </summary>
+    double GetTimeSinceStartup() const noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _StartupTime).count();
+    }
+
+    void SetStartupTime() noexcept { _StartupTime = std::chrono::steady_clock::now(); }
+
+    bool GetVersion(std::wstring & version) noexcept;
+    const std::wstring & GetUserDataFolderPath() noexcept;
+
+private:
+    void OnCreated(HRESULT hResult, ICoreWebView2Environment * environment) noexcept;
+
+private:
+    enum class state_t
+    {
+        Idle,
+        Creating,
+        Ready,
+    };
+
+    state_t _State;
+    HRESULT _Result;
+    int64_t _CreationStart;
+    std::chrono::steady_clock::time_point _StartupTime;
+
+    wil::com_ptr<ICoreWebView2Environment> _Environment;
+
+    std::vector<std::pair<const void *, callback_t>> _Callbacks; // The callbacks waiting for the environment to be created.
+
+    std::wstring _Version;
+    bool _IsVersionKnown;
+    bool _IsVersionAvailable;
+
+    std::wstring _UserDataFolderPath;
+};
+
+extern webview_environment_t _WebViewEnvironment;